@@ -0,0 +1,262 @@
+// KaefUtil_bench.cpp : timings of the DateTime hot paths; with -DDATETIME_INSTRUMENT=ON each timing is followed by the path counters
+//
+
+#include <DateTime.h>
+#include <DateTimeArray.h>
+#include <DateTime_boost.h>
+#include <DateTime_arrow.h>
+#include <DateTimeSearch.h>
+#include <DateTimeRollup.h>
+#include <DateTimeMerge.h>
+#include <DateTimeRolling.h>
+#include <DateTimeCounters.h>
+#include <Version.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <queue>
+#include <random>
+#include <vector>
+
+using namespace PROJECT_NAMESPACE;
+
+namespace {
+	volatile uint64_t sink; // keeps the optimiser from discarding the benchmarked loops
+
+	template<typename F>
+	void bench(const char* name, size_t n, F&& f) {
+		DateTimeCounters::reset();
+		const auto t0 = std::chrono::steady_clock::now();
+		f();
+		const auto t1 = std::chrono::steady_clock::now();
+		const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+		std::cout << '\n' << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(2)
+		          << std::setw(10) << ns / n << " ns/op\n";
+		if(DateTimeCounters::enabled)   DateTimeCounters::dump(std::cout);
+	}
+
+	std::vector<DateTime::dayOffset_t> randomOffsets(size_t n, DateTime::dayOffset_t lo, DateTime::dayOffset_t hi) {
+		std::mt19937_64 rng(12345);
+		std::uniform_int_distribution<DateTime::dayOffset_t> dist(lo, hi);
+		std::vector<DateTime::dayOffset_t> v(n);
+		for(auto& x : v)   x = dist(rng);
+		return v;
+	}
+} /* end of anonymous namespace */
+
+
+int main() {
+	constexpr size_t N = 4000000;
+	const DateTime::dayOffset_t o0 = DateTime::dayOffset(1900, 1, 1), o1 = DateTime::dayOffset(2100, 12, 31);
+	const auto offs  = randomOffsets(N, o0, o1);
+	const auto steps = randomOffsets(N, 0, 800);
+
+	bench("DateTime(dayOffset_t)", N, [&] {
+		uint64_t acc = 0;
+		for(auto o : offs)   acc += DateTime{ o }.day();
+		sink = acc;
+	});
+
+	bench("operator+=", N, [&] {
+		uint64_t acc = 0;
+		DateTime D(2000, 1, 1);
+		for(size_t i = 0;     i < N;     ++i) {
+			DateTime E = D + steps[i];
+			acc += E.day();
+		}
+		sink = acc;
+	});
+
+	bench("operator++", N, [&] {
+		DateTime D(1900, 1, 1);
+		for(size_t i = 0;     i < N;     ++i)   ++D;
+		sink = D.day();
+	});
+
+	std::vector<DateTime> dates;
+	dates.reserve(N);
+	for(auto o : offs)   dates.emplace_back(o);
+
+	bench("std::sort", N, [&] {
+		auto v = dates;
+		std::sort(v.begin(), v.end());
+		sink = v[N / 2].day();
+	});
+
+	bench("count operator<", N, [&] {
+		const DateTime pivot(2000, 6, 15);
+		sink = std::count_if(dates.begin(), dates.end(), [&](const DateTime& D) { return D < pivot; });
+	});
+
+	bench("isoWeekYear() + isoWeek()", N, [&] {
+		uint64_t acc = 0;
+		for(const auto& D : dates)   acc += D.isoWeekYear() + D.isoWeek();
+		sink = acc;
+	});
+
+	bench("isoWeekDates (array)", N, [&] {
+		std::vector<DateTime::year_t> Ys(N);
+		std::vector<DateTime::week_t> Ws(N);
+		isoWeekDates(dates.data(), N, Ys.data(), Ws.data());
+		sink = Ys[N / 2] + Ws[N / 2];
+	});
+
+	bench("exportArrow date32", N, [&] {
+		ArrowArray A;     ArrowSchema S;
+		exportArrow(dates.data(), N, ArrowDateFormat::DATE32, &A, &S);
+		sink = A.null_count;
+		A.release(&A);     S.release(&S);
+	});
+
+	std::vector<DateTime> sorted = dates;
+	std::sort(sorted.begin(), sorted.end());
+	const DateTimeIndex index(sorted.data(), N);
+	std::vector<size_t> found(N);
+
+	bench("std::upper_bound as-of probes", N, [&] {
+		for(size_t i = 0;     i < N;     ++i)   found[i] = std::upper_bound(sorted.begin(), sorted.end(), dates[i]) - sorted.begin();
+		sink = found[N / 2];
+	});
+
+	bench("DateTimeIndex::asOf, batched", N, [&] {
+		index.asOf(dates.data(), N, found.data());
+		sink = found[N / 2];
+	});
+
+	bench("asOfJoin, both sorted", N, [&] {
+		asOfJoin(sorted.data(), N, sorted.data(), N, found.data());
+		sink = found[N / 2];
+	});
+
+	DateTimeRollup rollup;
+	std::vector<double> daily(size_t(o1 - o0 + 1));
+	for(size_t i = 0;     i < N;     ++i)   { rollup.set(dates[i], double(i & 1023));     daily[size_t(offs[i] - o0)] = double(i & 1023); }
+	constexpr size_t Q = 10000;
+	const auto qFrom = randomOffsets(Q, o0, o1), qLen = randomOffsets(Q, 0, 20 * 366);
+
+	bench("rescan of daily values, random ranges", Q, [&] {
+		double acc = 0;
+		for(size_t i = 0;     i < Q;     ++i)
+			for(auto o = qFrom[i];     o <= std::min(qFrom[i] + qLen[i], o1);     ++o)   acc += daily[size_t(o - o0)];
+		sink = uint64_t(acc);
+	});
+
+	bench("DateTimeRollup::range, random ranges", Q, [&] {
+		double acc = 0;
+		for(size_t i = 0;     i < Q;     ++i)   acc += rollup.range(DateTime{ qFrom[i] }, DateTime{ qFrom[i] + qLen[i] }).sum;
+		sink = uint64_t(acc);
+	});
+
+	constexpr size_t K = 256;
+	std::vector<DateTime> streams = dates; // K sorted streams of N / K values each, one after the other
+	for(size_t s = 0;     s < K;     ++s)   std::sort(streams.begin() + s * (N / K), streams.begin() + (s + 1) * (N / K));
+	std::vector<DateTime> merged(N);
+
+	bench("std::priority_queue merge, 256 streams", N, [&] {
+		typedef std::pair<DateTime, size_t> Head; // value and stream; ties go to the lower stream index
+		auto later = [](const Head& a, const Head& b) { return b.first < a.first || (a.first == b.first && b.second < a.second); };
+		std::priority_queue<Head, std::vector<Head>, decltype(later)> q(later);
+		std::vector<size_t> pos(K);
+		for(size_t s = 0;     s < K;     ++s)   { pos[s] = s * (N / K);     q.emplace(streams[pos[s]], s); }
+		for(size_t o = 0;     !q.empty();     ++o) {
+			const size_t s = q.top().second;
+			merged[o] = q.top().first;
+			q.pop();
+			if(++pos[s] < (s + 1) * (N / K))   q.emplace(streams[pos[s]], s);
+		}
+		sink = merged[N / 2].day();
+	});
+
+	bench("DateTimeMerger, 256 streams", N, [&] {
+		std::vector<DateTimeArrayReader> readers;
+		std::vector<DateTimeReader*> ptrs;
+		for(size_t s = 0;     s < K;     ++s)   readers.emplace_back(streams.data() + s * (N / K), N / K, 4096);
+		for(auto& r : readers)   ptrs.push_back(&r);
+		DateTimeMerger M(ptrs.data(), K);
+		std::vector<uint32_t> ix(4096);
+		for(size_t o = 0, m;     (m = M.next(merged.data() + o, ix.data(), std::min<size_t>(4096, N - o))) != 0;     o += m) ;
+		sink = merged[N / 2].day();
+	});
+
+	// the same values, but dealt out to the streams in runs of 1000 consecutive values, so most values take the single-comparison path
+	std::vector<DateTime> runs = dates;
+	std::sort(runs.begin(), runs.end());
+	std::vector<DateTime> runStreams;
+	std::vector<size_t> runStart(K + 1); // stream \s is \{runStreams[runStart[s]...runStart[s + 1]]}
+	for(size_t s = 0;     s < K;     ++s) {
+		runStart[s] = runStreams.size();
+		for(size_t r = s * 1000;     r < N;     r += K * 1000)   runStreams.insert(runStreams.end(), runs.begin() + r, runs.begin() + std::min<size_t>(r + 1000, N));
+	}
+	runStart[K] = runStreams.size();
+
+	bench("DateTimeMerger, runs of 1000 values", N, [&] {
+		std::vector<DateTimeArrayReader> readers;
+		std::vector<DateTimeReader*> ptrs;
+		for(size_t s = 0;     s < K;     ++s)   readers.emplace_back(runStreams.data() + runStart[s], runStart[s + 1] - runStart[s], 4096);
+		for(auto& r : readers)   ptrs.push_back(&r);
+		DateTimeMerger M(ptrs.data(), K);
+		std::vector<uint32_t> ix(4096);
+		for(size_t o = 0, m;     (m = M.next(merged.data() + o, ix.data(), std::min<size_t>(4096, N - o))) != 0;     o += m) ;
+		sink = merged[N / 2].day();
+	});
+
+	std::vector<boost::gregorian::date> boostDates(N);
+
+	bench("boost date(year, month, day)", N, [&] {
+		for(size_t i = 0;     i < N;     ++i)   boostDates[i] = boost::gregorian::date(dates[i].year(), dates[i].month(), dates[i].day());
+		sink = boostDates[N / 2].day_number();
+	});
+
+	bench("toBoostDates", N, [&] {
+		toBoostDates(dates.data(), N, boostDates.data());
+		sink = boostDates[N / 2].day_number();
+	});
+
+	bench("fromBoostDate per element", N, [&] {
+		for(size_t i = 0;     i < N;     ++i)   merged[i] = fromBoostDate(boostDates[i]);
+		sink = merged[N / 2].day();
+	});
+
+	bench("fromBoostDates", N, [&] {
+		fromBoostDates(boostDates.data(), N, merged.data());
+		sink = merged[N / 2].day();
+	});
+
+	bench("operator==(DateTime, date) per element", N, [&] {
+		size_t i = 0;
+		while(i < N && dates[i] == boostDates[i])   ++i;
+		sink = i;
+	});
+
+	bench("equalBoostDates", N, [&] {
+		sink = equalBoostDates(dates.data(), boostDates.data(), N);
+	});
+
+	std::vector<double> values(N), sums(N), mins(N);
+	for(size_t i = 0;     i < N;     ++i)   values[i] = double(i & 1023);
+	constexpr size_t R = 100000; // the rescan is quadratic, so it only gets a prefix
+
+	bench("rescan of trailing 30 days, per value", R, [&] {
+		for(size_t i = 0, j = 0;     i < R;     ++i) {
+			const DateTime::dayOffset_t start = sorted[i].dayOffset() - 29;
+			while(sorted[j].dayOffset() < start)   ++j;
+			double sum = 0, mn = values[i];
+			for(size_t k = j;     k <= i;     ++k)   { sum += values[k];     mn = std::min(mn, values[k]); }
+			sums[i] = sum;     mins[i] = mn;
+		}
+		sink = uint64_t(sums[R / 2] + mins[R / 2]);
+	});
+
+	bench("rolling trailing 30 days", N, [&] {
+		rolling(sorted.data(), values.data(), N, RollingWindow::TRAILING_DAYS, 30, sums.data(), nullptr, mins.data(), nullptr);
+		sink = uint64_t(sums[N / 2] + mins[N / 2]);
+	});
+
+	bench("rolling year-to-date", N, [&] {
+		rolling(sorted.data(), values.data(), N, RollingWindow::YEAR_TO_DATE, 1, sums.data(), nullptr, mins.data(), nullptr);
+		sink = uint64_t(sums[N / 2] + mins[N / 2]);
+	});
+
+	std::cout << std::endl;
+}
@@ -18,10 +18,24 @@ struct DateTimeTestError : std::runtime_error {
 
 /* Note: each test presumes that all the others above it have been usccessfully performed */
 
-void DateTimeTestIterate();
+void DateTimeTestIterate(); // also monthLength(), isMonthFirst() and isMonthLast()
 
 void DateTimeTestDayOffset();
 
+void DateTimeTestIsoWeek(); // also tests the array function \isoWeekDates()
+
+void DateTimeTestArrow();
+
+void DateTimeTestSearch(); // \DateTimeIndex and \asOfJoin
+
+void DateTimeTestRollup();
+
+void DateTimeTestMerge(); // \DateTimeMerger with array, file, and memory-mapped readers
+
+void DateTimeTestBoostBulk(); // array conversions and comparison from DateTime_boost.h
+
+void DateTimeTestRolling();
+
 
 
 } /* end of namespace DateTimeTest*/
@@ -1,6 +1,17 @@
 #include "DateTimeTest.h"
+#include <DateTimeArray.h>
+#include <DateTime_arrow.h>
+#include <DateTimeSearch.h>
+#include <DateTimeRollup.h>
+#include <DateTimeMerge.h>
+#include <DateTimeRolling.h>
 #include <Version.h>
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
+#include <map>
+#include <random>
+#include <vector>
 
 using namespace PROJECT_NAMESPACE;
 using namespace DateTimeTest;
@@ -27,8 +38,16 @@ void DateTimeTest::DateTimeTestIterate() {
 	const date_duration oneDay(1);
 	DateTime d = fromBoostDate(b);
 	if(d != b)     throw DateTimeTestError("Iteration test: setting min date", d, b);
-	for(size_t i = 0;     i < 1100*365;     ++i)
+	if(DateTime(2001, 2, 1).monthLength() != 28 || DateTime(2000, 2, 1).monthLength() != 29 || DateTime(1900, 2, 1).monthLength() != 28)
+		throw DateTimeTestError("Iteration test: February length", DateTime(2001, 2, 1), DateTime(2001, 2, 1).monthLength());
+	if(!DateTime(2001, 3, 1).isMonthFirst() || DateTime(2001, 3, 2).isMonthFirst() || DateTime{}.isMonthFirst())
+		throw DateTimeTestError("Iteration test: first of month", DateTime(2001, 3, 1), 0);
+	for(size_t i = 0;     i < 1100*365;     ++i) {
 		if((b += oneDay) != ++d)   throw DateTimeTestError("Iteration test: ++", d, b);
+		if(d.monthLength() != b.end_of_month().day())   throw DateTimeTestError("Iteration test: monthLength", d, b);
+		if(d.isMonthFirst() != (b.day() == 1))          throw DateTimeTestError("Iteration test: isMonthFirst", d, b);
+		if(d.isMonthLast() != (b == b.end_of_month()))  throw DateTimeTestError("Iteration test: isMonthLast", d, b);
+	}
 	for(size_t i = 0;     i < 1100*365;     ++i)
 		if((b -= oneDay) != --d)   throw DateTimeTestError("Iteration test: --", d, b);
 }
@@ -42,4 +61,363 @@ void DateTimeTest::DateTimeTestDayOffset() {
 		if(d.dayOffset() != ++t)          throw DateTimeTestError("day offset test: get offset", d,  t);
 		if(!d2.dayOffset(t) || d2 != d)   throw DateTimeTestError("day offset test: set offset", d2, t);
 	}
+	// both ends of the storable range, including the leap year \minYear
+	if(DateTime{ DateTime::minDayOffset } != DateTime::minDate() || DateTime::minDate().dayOffset() != DateTime::minDayOffset)
+		throw DateTimeTestError("day offset test: min date", DateTime::minDate(), DateTime::minDayOffset);
+	if(DateTime{ DateTime::maxDayOffset } != DateTime::maxDate() || DateTime::maxDate().dayOffset() != DateTime::maxDayOffset)
+		throw DateTimeTestError("day offset test: max date", DateTime::maxDate(), DateTime::maxDayOffset);
+	for(DateTime::dayOffset_t t : { DateTime::minDayOffset - 1, DateTime::maxDayOffset + 1 })
+		if(DateTime{ t }.hasYear())   throw DateTimeTestError("day offset test: outside range", DateTime{ t }, t);
+	for(d = DateTime::minDate(), t = DateTime::minDayOffset;     t < DateTime::minDayOffset + 800;     ++d, ++t)
+		if(d.dayOffset() != t || DateTime{ t } != d || d.weekday() != (((t % 7) + 8) % 7) + 1)   throw DateTimeTestError("day offset test: after min date", d, t);
+	for(d = DateTime::maxDate(), t = DateTime::maxDayOffset;     t > DateTime::maxDayOffset - 800;     --d, --t)
+		if(d.dayOffset() != t || DateTime{ t } != d || d.weekday() != (((t % 7) + 8) % 7) + 1)   throw DateTimeTestError("day offset test: before max date", d, t);
+}
+
+
+void DateTimeTest::DateTimeTestIsoWeek() {
+	date b(1601, 1, 1);
+	const date bEnd(2401, 1, 1);
+	const date_duration oneDay(1);
+	std::vector<DateTime> v;
+	for(;     b < bEnd;     b += oneDay) {
+		const DateTime d = fromBoostDate(b);
+		const int W = b.week_number();
+		const int Y = b.year() + (W == 1 && b.month() == 12) - (W >= 52 && b.month() == 1);
+		if(d.isoWeek() != W)        throw DateTimeTestError("ISO week test: week", d, b);
+		if(d.isoWeekYear() != Y)    throw DateTimeTestError("ISO week test: week-year", d, b);
+		if(DateTime::fromIsoWeekDate(Y, W, d.weekday()) != d)   throw DateTimeTestError("ISO week test: from week date", d, b);
+		v.push_back(d);
+	}
+	v.push_back(DateTime{});
+	std::vector<DateTime::year_t> Ys(v.size());
+	std::vector<DateTime::week_t> Ws(v.size()), Ws2(v.size());
+	isoWeekDates(v.data(), v.size(), Ys.data(), Ws.data());
+	isoWeeks(v.data(), v.size(), Ws2.data());
+	for(size_t i = 0;     i < v.size();     ++i) {
+		if(Ys[i] != v[i].isoWeekYear() || Ws[i] != v[i].isoWeek())   throw DateTimeTestError("ISO week test: array version", v[i], 0);
+		if(Ws2[i] != v[i].isoWeek())                                 throw DateTimeTestError("ISO week test: isoWeeks", v[i], Ws2[i]);
+	}
+
+	// the year boundaries: weeks 52 and 53 that reach into January, and week 1 that starts in December
+	const DateTime edges[] = { DateTime(2017, 1, 1), DateTime(2018, 12, 31), DateTime(2020, 12, 31), DateTime(2021, 1, 3), DateTime(2021, 1, 4), DateTime(2015, 12, 31) };
+	const DateTime::week_t edgeWeeks[] = { 52, 1, 53, 53, 1, 53 };
+	DateTime::week_t W[6];
+	isoWeeks(edges, 6, W);
+	for(size_t i = 0;     i < 6;     ++i)
+		if(W[i] != edgeWeeks[i] || edges[i].isoWeek() != edgeWeeks[i])   throw DateTimeTestError("ISO week test: year boundaries", edges[i], W[i]);
+}
+
+
+void DateTimeTest::DateTimeTestArrow() {
+	const DateTime known[] = { DateTime(1970, 1, 1), DateTime(1969, 12, 31), DateTime(2000, 3, 1), DateTime{} };
+	int32_t days[4];     uint8_t validity[1];
+	if(toArrowDate32(known, 4, days, validity) != 1 || validity[0] != 0x07)   throw DateTimeTestError("Arrow test: validity", known[3], 0);
+	if(days[0] != 0)       throw DateTimeTestError("Arrow test: epoch",     known[0], days[0]);
+	if(days[1] != -1)      throw DateTimeTestError("Arrow test: epoch - 1", known[1], days[1]);
+	if(days[2] != 11017)   throw DateTimeTestError("Arrow test: date32",    known[2], days[2]);
+
+	std::vector<DateTime> v, v2;
+	for(DateTime::dayOffset_t t = DateTime::dayOffset(-3000, 1, 1);     t < DateTime::dayOffset(3000, 1, 1);     t += 97) {
+		DateTime d{ t };
+		if(t % 5)   d.time(DateTime::timeOfDay_t((t - DateTime::minDayOffset) % 86400000));
+		v.push_back(d);
+	}
+	v.push_back(DateTime{});
+	v2.resize(v.size());
+	for(ArrowDateFormat F : { ArrowDateFormat::DATE32, ArrowDateFormat::DATE64, ArrowDateFormat::TIMESTAMP_MS }) {
+		ArrowArray A;     ArrowSchema S;
+		exportArrow(v.data(), v.size(), F, &A, &S);
+		if(A.null_count != 1 || !importArrow(&A, &S, v2.data()))   throw DateTimeTestError("Arrow test: export", v.back(), A.null_count);
+		A.release(&A);     S.release(&S);
+		for(size_t i = 0;     i < v.size();     ++i) {
+			DateTime d = v[i];
+			if(F != ArrowDateFormat::TIMESTAMP_MS)   d.unsetTime();
+			else if(d.hasDay() && !d.hasTime())      d.time(DateTime::timeOfDay_t(0)); // n/a time-of-day is exported as 00:00
+			if(v2[i] != d)   throw DateTimeTestError("Arrow test: round trip", v2[i], int64_t(F));
+		}
+	}
+
+	// zero-copy export of buffers that are already in Arrow layout
+	std::vector<int32_t> days32(v.size());
+	std::vector<uint8_t> bitmap((v.size() + 7) / 8);
+	const int64_t nulls = toArrowDate32(v.data(), v.size(), days32.data(), bitmap.data());
+	ArrowArray A;     ArrowSchema S;
+	exportArrowView(days32.data(), bitmap.data(), v.size(), nulls, ArrowDateFormat::DATE32, &A, &S);
+	if(A.buffers[1] != days32.data() || A.buffers[0] != bitmap.data() || A.null_count != nulls)
+		throw DateTimeTestError("Arrow test: view aliases the source buffers", v.back(), nulls);
+	std::fill(v2.begin(), v2.end(), DateTime(2000, 1, 1));
+	if(!importArrow(&A, &S, v2.data()))   throw DateTimeTestError("Arrow test: view import", v.back(), 0);
+	A.release(&A);     S.release(&S);
+	for(size_t i = 0;     i < v.size();     ++i) {
+		DateTime d = v[i];
+		d.unsetTime();
+		if(v2[i] != d)   throw DateTimeTestError("Arrow test: view round trip", v2[i], int64_t(i));
+	}
+
+	// malformed input is rejected instead of dereferenced
+	exportArrow(v.data(), v.size(), ArrowDateFormat::DATE32, &A, &S);
+	const char* format = S.format;
+	const void** buffers = A.buffers;
+	const void* noValues[2] = { buffers[0], nullptr }, * noBitmap[2] = { nullptr, buffers[1] };
+	S.format = nullptr;
+	if(importArrow(&A, &S, v2.data()))   throw DateTimeTestError("Arrow test: no format", v.back(), 0);
+	S.format = format;     A.n_buffers = 1;
+	if(importArrow(&A, &S, v2.data()))   throw DateTimeTestError("Arrow test: buffer count", v.back(), A.n_buffers);
+	A.n_buffers = 2;     A.buffers = noValues;
+	if(importArrow(&A, &S, v2.data()))   throw DateTimeTestError("Arrow test: no value buffer", v.back(), 0);
+	A.buffers = noBitmap;
+	if(importArrow(&A, &S, v2.data()))   throw DateTimeTestError("Arrow test: nulls without bitmap", v.back(), A.null_count);
+	A.buffers = buffers;
+	if(!importArrow(&A, &S, v2.data()))  throw DateTimeTestError("Arrow test: restored array", v.back(), 0);
+	A.release(&A);     S.release(&S);
+}
+
+
+void DateTimeTest::DateTimeTestSearch() {
+	std::mt19937 rng(4711);
+	std::uniform_int_distribution<DateTime::dayOffset_t> day(DateTime::dayOffset(1990, 1, 1), DateTime::dayOffset(2030, 1, 1));
+	std::uniform_int_distribution<DateTime::timeOfDay_t> ms(0, 86399999);
+	auto randomDates = [&](size_t n) {
+		std::vector<DateTime> v(n);
+		for(auto& d : v)   { d.dayOffset(day(rng));     if(ms(rng) & 1)   d.time(ms(rng)); }
+		std::sort(v.begin(), v.end());
+		return v;
+	};
+
+	for(size_t n : { 0, 1, 2, 7, 8, 1000, 4097 }) {
+		std::vector<DateTime> quotes = randomDates(n), events = randomDates(2000);
+		if(n > 2)   { events[10] = quotes[1];     quotes[2] = quotes[1];     std::sort(events.begin(), events.end()); } // exact hits and duplicates
+		const DateTimeIndex ix(quotes.data(), n);
+		std::vector<size_t> lb(events.size()), ub(events.size()), ao(events.size()), joined(events.size());
+		ix.lowerBound(events.data(), events.size(), lb.data());
+		ix.upperBound(events.data(), events.size(), ub.data());
+		ix.asOf      (events.data(), events.size(), ao.data());
+		asOfJoin(events.data(), events.size(), quotes.data(), n, joined.data());
+		for(size_t i = 0;     i < events.size();     ++i) {
+			const DateTime& e = events[i];
+			const size_t l = std::lower_bound(quotes.begin(), quotes.end(), e) - quotes.begin(),
+			             u = std::upper_bound(quotes.begin(), quotes.end(), e) - quotes.begin();
+			if(ix.lowerBound(e) != l || lb[i] != l)   throw DateTimeTestError("Search test: lower bound", e, int64_t(n));
+			if(ix.upperBound(e) != u || ub[i] != u)   throw DateTimeTestError("Search test: upper bound", e, int64_t(n));
+			const size_t a = (u ? u - 1 : NOINDEX);
+			if(ix.asOf(e) != a || ao[i] != a || joined[i] != a)   throw DateTimeTestError("Search test: as-of", e, int64_t(n));
+		}
+	}
+
+	const DateTime quotes[] = { DateTime(2020, 1, 1), DateTime(2020, 1, 10) };
+	DateTime events[] = { DateTime(2019, 12, 31), DateTime(2020, 1, 3), DateTime(2020, 1, 4), DateTime(2020, 1, 10) };
+	events[3].time(DateTime::timeOfDay_t(1));
+	size_t match[4];
+	asOfJoin(events, 4, quotes, 2, match, 2, ToleranceUnit::DAYS);
+	if(match[0] != NOINDEX || match[1] != 0 || match[2] != NOINDEX || match[3] != 1)   throw DateTimeTestError("Search test: tolerance in days", events[2], 2);
+	asOfJoin(events, 4, quotes, 2, match, 0, ToleranceUnit::MILLISECONDS);
+	if(match[3] != NOINDEX)   throw DateTimeTestError("Search test: tolerance in ms", events[3], 0);
+}
+
+
+void DateTimeTest::DateTimeTestRollup() {
+	std::mt19937 rng(815);
+	const DateTime::dayOffset_t o0 = DateTime::dayOffset(1995, 1, 1), o1 = DateTime::dayOffset(2004, 12, 31);
+	std::uniform_int_distribution<DateTime::dayOffset_t> day(o0, o1);
+	std::uniform_int_distribution<int> value(-1000, 1000), op(0, 9);
+	DateTimeRollup R;
+	std::map<DateTime::dayOffset_t, double> plain; // reference data
+	auto check = [&](DateTime::dayOffset_t from, DateTime::dayOffset_t to) {
+		DateTimeRollup::Aggregate ref;
+		for(auto it = plain.lower_bound(from);     it != plain.end() && it->first <= to;     ++it)
+			ref += DateTimeRollup::Aggregate{ it->second, 1, it->second, it->second };
+		const DateTimeRollup::Aggregate a = R.range(DateTime{ from }, DateTime{ to, DateTime::timeOfDay_t(1000) });
+		if(a.count != ref.count || a.sum != ref.sum || a.min != ref.min || a.max != ref.max) // integer values, so the sums are exact
+			throw DateTimeTestError("Rollup test: range aggregate", DateTime{ from }, to - from);
+	};
+
+	for(size_t i = 0;     i < 20000;     ++i) {
+		const DateTime::dayOffset_t o = day(rng);
+		if(op(rng) < 2)   { if(R.erase(DateTime{ o }) != (plain.erase(o) != 0))   throw DateTimeTestError("Rollup test: erase", DateTime{ o }, o); }
+		else              { const double v = value(rng);     R.set(DateTime{ o }, v);     plain[o] = v; }
+		if(i % 100 == 0) {
+			const DateTime::dayOffset_t a = day(rng), b = day(rng);
+			check(std::min(a, b), std::max(a, b));
+		}
+	}
+	if(R.size() != plain.size())   throw DateTimeTestError("Rollup test: size", DateTime{ o0 }, R.size());
+	check(o0 - 1000, o1 + 1000);
+	check(DateTime::dayOffset(1996, 1, 1), DateTime::dayOffset(2003, 12, 31)); // whole years only
+	check(DateTime::dayOffset(1996, 2, 29), DateTime::dayOffset(1996, 3, 31));
+
+	const DateTime D(2000, 2, 10);
+	if(R.month(D).count != R.range(D.monthFirst(), D.monthLast()).count || R.year(D).max != R.range(D.yearFirst(), D.yearLast()).max)
+		throw DateTimeTestError("Rollup test: month and year nodes", D, 0);
+	if(!(DateTimeRollup::monthKey(D) > D.monthLast()) || DateTimeRollup::monthKey(D).hasDay() || DateTimeRollup::yearKey(D).hasMonth())
+		throw DateTimeTestError("Rollup test: partial-resolution keys", DateTimeRollup::monthKey(D), 0);
+	if(R.set(DateTime{}, 1) || R.range(DateTime{}, D).count)   throw DateTimeTestError("Rollup test: n/a dates", DateTime{}, 0);
+}
+
+
+void DateTimeTest::DateTimeTestMerge() {
+	std::mt19937 rng(1234);
+	std::uniform_int_distribution<DateTime::dayOffset_t> day(DateTime::dayOffset(2020, 1, 1), DateTime::dayOffset(2020, 3, 1)); // narrow, so there are many ties
+	std::uniform_int_distribution<size_t> len(0, 300);
+	struct Item { DateTime D;     uint32_t s; };
+
+	for(size_t k : { 1, 2, 3, 5, 8, 100 }) {
+		std::vector<std::vector<DateTime>> streams(k);
+		std::vector<Item> expected;
+		for(uint32_t s = 0;     s < k;     ++s) {
+			streams[s].resize(len(rng));
+			for(auto& D : streams[s])   { D.dayOffset(day(rng));     if(len(rng) & 1)   D.time(DateTime::timeOfDay_t(len(rng))); }
+			std::sort(streams[s].begin(), streams[s].end());
+			for(const auto& D : streams[s])   expected.push_back(Item{ D, s });
+		}
+		std::stable_sort(expected.begin(), expected.end(), [](const Item& a, const Item& b) { return a.D < b.D; }); // ties keep stream order
+
+		std::vector<DateTimeArrayReader> readers;
+		std::vector<DateTimeReader*> ptrs;
+		for(const auto& v : streams)   readers.emplace_back(v.data(), v.size(), 7); // small blocks to cross block boundaries within runs
+		for(auto& r : readers)   ptrs.push_back(&r);
+		DateTimeMerger M(ptrs.data(), k);
+		std::vector<DateTime> out(expected.size() + 1);
+		std::vector<uint32_t> ix(expected.size() + 1);
+		size_t n = 0;
+		for(size_t m;     (m = M.next(out.data() + n, ix.data() + n, std::min<size_t>(13, out.size() - n))) != 0;     n += m) ;
+		if(n != expected.size() || !M.done())   throw DateTimeTestError("Merge test: number of merged values", DateTime{}, int64_t(n));
+		for(size_t i = 0;     i < n;     ++i)
+			if(out[i] != expected[i].D || ix[i] != expected[i].s)   throw DateTimeTestError("Merge test: order", out[i], int64_t(i));
+	}
+
+	std::vector<DateTime> v(1000);
+	for(auto& D : v)   D.dayOffset(day(rng));
+	std::sort(v.begin(), v.end());
+	const char* path = "DateTimeMerge_test.bin";
+	std::FILE* f = std::fopen(path, "wb");
+	if(!f)   throw DateTimeTestError("Merge test: can't write test file", DateTime{}, 0);
+	std::fwrite(v.data(), sizeof(DateTime), 500, f); // the file holds the first half, memory the second
+	std::fclose(f);
+	{
+		DateTimeFileReader   file  (path, 64);
+		DateTimeMappedReader mapped(path);
+		DateTimeArrayReader  memory(v.data() + 500, 500);
+		if(!file.isOpen() || !mapped.isOpen())   throw DateTimeTestError("Merge test: can't read test file", DateTime{}, 0);
+		DateTimeReader* ptrs[] = { &file, &memory, &mapped };
+		DateTimeMerger M(ptrs, 3);
+		std::vector<DateTime> out(1500);
+		std::vector<uint32_t> ix(1500);
+		if(M.next(out.data(), ix.data(), out.size()) != 1500 || !M.done())   throw DateTimeTestError("Merge test: file readers", DateTime{}, 0);
+		for(size_t i = 1;     i < 1500;     ++i)
+			if(out[i] < out[i - 1] || (out[i] == out[i - 1] && ix[i] < ix[i - 1]))   throw DateTimeTestError("Merge test: file readers", out[i], int64_t(i));
+	}
+	std::remove(path);
+}
+
+
+void DateTimeTest::DateTimeTestBoostBulk() {
+	const DateTime::dayOffset_t o0 = DateTime::dayOffset(1400, 1, 1), o1 = DateTime::dayOffset(2600, 12, 31);
+	std::vector<DateTime> D;
+	std::vector<date> B;
+	for(DateTime::dayOffset_t o = o0;     o <= o1;     ++o) {
+		D.emplace_back(o);
+		B.emplace_back(D.back().year(), D.back().month(), D.back().day());
+	}
+	D.emplace_back(DateTime::dayOffset(9999, 12, 31));     B.emplace_back(9999, 12, 31);
+	std::vector<date> toB(D.size());
+	std::vector<DateTime> fromB(B.size());
+	toBoostDates(D.data(), D.size(), toB.data());
+	fromBoostDates(B.data(), B.size(), fromB.data());
+	for(size_t i = 0;     i < D.size();     ++i) {
+		if(toB[i] != B[i])     throw DateTimeTestError("Boost bulk test: toBoostDates", D[i], B[i]);
+		if(fromB[i] != D[i])   throw DateTimeTestError("Boost bulk test: fromBoostDates", fromB[i], B[i]);
+	}
+	size_t at = 0;
+	if(!equalBoostDates(D.data(), B.data(), D.size(), &at) || at != D.size())   throw DateTimeTestError("Boost bulk test: equality", D[at], B[at]);
+	B[1000] += date_duration(1);
+	if(equalBoostDates(D.data(), B.data(), D.size(), &at) || at != 1000)   throw DateTimeTestError("Boost bulk test: inequality", D[1000], B[1000]);
+
+	// n/a and out-of-range values, which boost's own constructors would reject with exceptions
+	const DateTime odd[] = { DateTime{}, DateTime(1399, 12, 31), DateTime(10000, 1, 1), DateTime(2000, 13, 1) };
+	const date special[] = { date(not_a_date_time), date(pos_infin), date(neg_infin), date(not_a_date_time) };
+	date oddB[4];
+	DateTime specialD[4];
+	toBoostDates(odd, 4, oddB);
+	fromBoostDates(special, 4, specialD);
+	for(size_t i = 0;     i < 4;     ++i) {
+		if(!oddB[i].is_not_a_date())   throw DateTimeTestError("Boost bulk test: out of range", odd[i], oddB[i]);
+		if(specialD[i].hasYear())      throw DateTimeTestError("Boost bulk test: special values", specialD[i], 0);
+		if(!toBoostDate(odd[i]).is_not_a_date() || fromBoostDate(special[i]).hasYear())
+			throw DateTimeTestError("Boost bulk test: single values", odd[i], 0);
+	}
+	const DateTime::dayOffset_t edges[] = { DateTime::dayOffset(DateTime::minYear, 1, 1), DateTime::dayOffset(DateTime::minYear, 3, 1),
+	                                        DateTime::dayOffset(DateTime::maxYear, 12, 31), DateTime::dayOffset(0, 2, 29), DateTime::dayOffset(DateTime::minYear, 1, 1) - 1,
+	                                        DateTime::dayOffset(DateTime::maxYear, 12, 31) + 1, DateTime::NODAYOFFSET, -DateTime::NODAYOFFSET };
+	DateTime fromOffs[8];
+	DateTime::dayOffset_t offs[8];
+	fromDayOffsets(edges, 8, fromOffs);
+	dayOffsets(fromOffs, 8, offs);
+	for(size_t i = 0;     i < 8;     ++i)
+		if(fromOffs[i] != DateTime{ edges[i] } || offs[i] != DateTime{ edges[i] }.dayOffset() || fromOffs[i].hasDay() != (i < 4))
+			throw DateTimeTestError("Boost bulk test: day offset arrays", fromOffs[i], edges[i]);
+
+	const date nadt[] = { date(not_a_date_time), date(not_a_date_time) };
+	if(!equalBoostDates(odd, nadt, 1) || equalBoostDates(odd + 1, nadt, 2))   throw DateTimeTestError("Boost bulk test: n/a equality", odd[1], 0);
+	// the scalar operators agree with the batch comparison, also for n/a and out-of-range values
+	const DateTime scalarD[] = { DateTime{}, DateTime{}, DateTime(1399, 12, 31), DateTime(10000, 1, 1), DateTime(1400, 1, 1), DateTime(2000, 2, 29), DateTime(2000, 2, 29) };
+	const date     scalarB[] = { date(not_a_date_time), date(pos_infin), date(not_a_date_time), date(not_a_date_time), date(1400, 1, 1), date(2000, 2, 29), date(2000, 3, 1) };
+	for(size_t i = 0;     i < 7;     ++i) {
+		const bool batch = equalBoostDates(scalarD + i, scalarB + i, 1);
+		if((scalarD[i] == scalarB[i]) != batch || (scalarB[i] == scalarD[i]) != batch || (scalarD[i] != scalarB[i]) == batch || (scalarB[i] != scalarD[i]) == batch)
+			throw DateTimeTestError("Boost bulk test: scalar vs. batch equality", scalarD[i], scalarB[i]);
+		if(batch != (i == 0 || i == 4 || i == 5))   throw DateTimeTestError("Boost bulk test: scalar equality", scalarD[i], scalarB[i]);
+	}
+}
+
+
+void DateTimeTest::DateTimeTestRolling() {
+	std::mt19937 rng(2718);
+	std::uniform_int_distribution<int> gap(0, 6), value(-100, 100); // gaps of up to six days, several values on some days
+	std::vector<DateTime> D;
+	std::vector<double> V;
+	for(DateTime::dayOffset_t o = DateTime::dayOffset(1999, 11, 20);     o < DateTime::dayOffset(2001, 2, 10);     o += gap(rng) / 2) {
+		D.emplace_back(o);
+		V.push_back(value(rng));
+	}
+	const size_t n = D.size();
+	D[n / 2].time(12, 0); // time-of-day doesn't matter
+
+	// reference: the first day of each window, found by walking backwards one day at a time
+	auto start = [](RollingWindow kind, unsigned int len, const DateTime& last) {
+		DateTime S = last;
+		S.unsetTime();
+		switch(kind) {
+		case RollingWindow::TRAILING_DAYS:   for(unsigned int i = 1;     i < len;     ++i)   --S;     break;
+		case RollingWindow::MONTH_TO_DATE:   while(S.day() != 1)   --S;     break;
+		case RollingWindow::YEAR_TO_DATE:    while(S.dayInYear() != 1)   --S;     break;
+		case RollingWindow::BUSINESS_DAYS:
+			for(unsigned int k = 0;     ;     --S)
+				if(S.weekday() != DateTime::Saturday && S.weekday() != DateTime::Sunday && ++k == len)   break;
+			break;
+		}
+		return S.dayOffset();
+	};
+
+	const std::pair<RollingWindow, unsigned int> windows[] = { { RollingWindow::TRAILING_DAYS, 1 }, { RollingWindow::TRAILING_DAYS, 30 },
+		{ RollingWindow::MONTH_TO_DATE, 1 }, { RollingWindow::YEAR_TO_DATE, 1 }, { RollingWindow::BUSINESS_DAYS, 1 }, { RollingWindow::BUSINESS_DAYS, 7 },
+		{ RollingWindow::BUSINESS_DAYS, 10 } };
+	std::vector<double> sums(n), means(n), mins(n), maxs(n);
+	std::vector<size_t> counts(n);
+	for(const auto& w : windows) {
+		rolling(D.data(), V.data(), n, w.first, w.second, sums.data(), means.data(), mins.data(), maxs.data(), counts.data());
+		for(size_t i = 0;     i < n;     ++i) {
+			const DateTime::dayOffset_t s = start(w.first, w.second, D[i]);
+			double sum = 0, mn = V[i], mx = V[i];
+			size_t count = 0;
+			for(size_t j = i + 1;     j-- > 0 && D[j].dayOffset() >= s;     ) { sum += V[j];     mn = std::min(mn, V[j]);     mx = std::max(mx, V[j]);     ++count; }
+			if(sums[i] != sum || counts[i] != count || means[i] != sum / count || mins[i] != mn || maxs[i] != mx) // integer values, so the sums are exact
+				throw DateTimeTestError("Rolling window test", D[i], int64_t(w.second));
+		}
+	}
+
+	DateTimeRolling R(RollingWindow::TRAILING_DAYS, 5);
+	if(R.count() || R.min() == R.min())   throw DateTimeTestError("Rolling window test: empty window", DateTime{}, 0);
+	if(!R.push(DateTime(2020, 1, 10), 1) || R.push(DateTime(2020, 1, 9), 2) || R.push(DateTime{}, 3) || R.count() != 1)
+		throw DateTimeTestError("Rolling window test: out-of-order and n/a dates", DateTime(2020, 1, 9), 0);
 }
@@ -27,6 +27,34 @@ int main() {
 	cout << "\n[Testing day offsets] ...";
 	DateTimeTestDayOffset();
 	cout << " [done!]";
+
+	cout << "\n[Testing ISO week dates] ...";
+	DateTimeTestIsoWeek();
+	cout << " [done!]";
+
+	cout << "\n[Testing Arrow export/import] ...";
+	DateTimeTestArrow();
+	cout << " [done!]";
+
+	cout << "\n[Testing sorted search] ...";
+	DateTimeTestSearch();
+	cout << " [done!]";
+
+	cout << "\n[Testing rollup cache] ...";
+	DateTimeTestRollup();
+	cout << " [done!]";
+
+	cout << "\n[Testing k-way merge] ...";
+	DateTimeTestMerge();
+	cout << " [done!]";
+
+	cout << "\n[Testing bulk boost conversion] ...";
+	DateTimeTestBoostBulk();
+	cout << " [done!]";
+
+	cout << "\n[Testing rolling windows] ...";
+	DateTimeTestRolling();
+	cout << " [done!]";
 /*#define RELAX(...) __VA_ARGS__
 #define CONTENT(a,...) __VA_ARGS__
 #define INPUT(FLD, GRP, GFLD) \
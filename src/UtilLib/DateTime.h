@@ -1,6 +1,9 @@
 #pragma once
 
 #include "DateTimeBase.h"
+#include "DateTimeCounters.h"
+
+#include <cstring>
 
 namespace PROJECT_NAMESPACE {
 
@@ -28,6 +31,7 @@ public:
 	typedef unsigned short dayInYear_t;
 	typedef unsigned char  day_t;
 	typedef unsigned char  month_t;
+	typedef unsigned char  week_t;      // ISO 8601 week number
 	typedef unsigned int   timeOfDay_t; // in milliseconds
 	typedef int64_t        dayOffset_t;
 	enum Months  : month_t { Jan = 1, Feb, Mar, Apr, May, Jun, Jul, Aug, Sep, Oct, Nov, Dec, NOMONTH = 1 << 4 };
@@ -42,8 +46,8 @@ public:
 	                        minYear   = - DateTimeBase::floor400(DateTime::year_t(1) << 27),
 	                        maxYear   = minYear + yearRange;
 	constexpr static timeOfDay_t maxTime      = 30 * 3600000; // we're generous with allowing days longer than 24h because leap days and whatnot
-	constexpr static dayOffset_t minDayOffset = DateTimeBase::dayOffset_<minYear>(1, 0, 0),               // range of day offsets
-	                             maxDayOffset = DateTimeBase::dayOffset_<minYear>(yearRange + 1, 11, 30); // that fit into \DateTime
+	constexpr static dayOffset_t minDayOffset = DateTimeBase::dayOffset_<minYear>(0, 0, 0),           // range of day offsets that fit into \DateTime,
+	                             maxDayOffset = DateTimeBase::dayOffset_<minYear>(yearRange, 11, 30); // i.e. \minDate() and \maxDate()
 
 	/* The constants defined above makes the B.C. and the A.D. range slightly different, but that doesn't matter.                     */
 	/* The earliest possible date falls inside the Cretaceous period, making this type insufficient for most paleontologists. Sorry!! */
@@ -54,10 +58,11 @@ public:
 	static_assert(maxYear - minYear <= yearRange, "[minYear,maxYear] must not span more numbers than can fit into 28 bits minus one reserved value");
 
 	/* Static functions  we don't really need more than those because constructing a \DateTime object and using its object methods is cheap.      */
-	/* These four functions work for all years that fit into \year_t, including those outside the valid range of \DateTime [\minYear...\maxYear].  */
+	/* These five functions work for all years that fit into \year_t, including those outside the valid range of \DateTime [\minYear...\maxYear].  */
 	constexpr static bool        isLeapYear (year_t);
 	constexpr static dayInYear_t yearLength (year_t);
 	constexpr static day_t       monthLength(year_t, month_t); // returns 0 for invalid month numbers (outside 1...12)
+	constexpr static week_t      isoWeeksInYear(year_t);       // 52 or 53 weeks in the ISO 8601 week-year
 	/* Offset in days from date 0001-01-01 (== offset 0); returns \NODAYOFFSET if there's illegal month or day input */
 	constexpr static dayOffset_t dayOffset  (year_t, month_t, day_t);
 
@@ -65,9 +70,12 @@ public:
 	constexpr DateTime(year_t, month_t, day_t, timeOfDay_t = NOTIME);
 	constexpr DateTime();
 	constexpr DateTime(dayOffset_t offs, timeOfDay_t = NOTIME);
+	/* ISO 8601 week date, e.g. (2021, 1, Monday) is 2021-01-04; returns an n/a date for illegal weeks or weekdays */
+	constexpr static DateTime fromIsoWeekDate(year_t isoWeekYear, week_t, Weekday);
 
-	DateTime(const DateTime&); // there's nothing to gain from rvalue functionality, so we don't add it
-	DateTime& operator=(const DateTime&); // also copies time-of-day, of course
+	/* \DateTime is trivially copyable, so arrays of it can be moved around with \memcpy and it can be used in \std::atomic */
+	DateTime(const DateTime&) = default; // there's nothing to gain from rvalue functionality, so we don't add it
+	DateTime& operator=(const DateTime&) = default; // also copies time-of-day, of course
 
 	/* retrieve values  if the fields involved are n/a the functions return the constants \NOYEAR, \NOMONTH, \NODAY */
 	constexpr year_t      year()      const;
@@ -76,6 +84,10 @@ public:
 	constexpr dayInYear_t dayInYear() const; // returns a value 1...365 (366 for leap years) (0 if day is n/a)
 	constexpr dayOffset_t dayOffset() const;
 	constexpr timeOfDay_t time()      const;
+	/* ISO 8601 week (1...53, 0 if day is n/a) and week-year (\NOYEAR if day is n/a). Weeks start on Monday, week 1 contains the */
+	/* first Thursday of the year, so for a few days around new year the week-year differs from \year() by one.                  */
+	constexpr week_t      isoWeek()     const;
+	constexpr year_t      isoWeekYear() const;
 
 	/* validity testers */
 	/* Since n/a in any unit implies n/a in all shorter units (except for time-of-day), a date has valid year, month, and day (a full date) iff it has a valid day value */
@@ -150,6 +162,9 @@ public:
 	bool operator<=(const DateTime&) const;
 	bool operator>=(const DateTime&) const;
 
+	/* The value as one unsigned 64 bit integer, ordered exactly like the comparison operators above. Use it as a sort or search key. */
+	uint64_t rawKey() const   { return word(); }
+
 	/* if offset leads to a date outside the possible range, the date will be invalid */
 	/* Time-of-day is left unchanged.                                                 */
 	DateTime& operator+=(dayOffset_t);
@@ -171,8 +186,18 @@ public:
 	int parse(const char*);
 
 private:
+	friend class DateTimeRollup; // builds its month and year keys from raw words
 	DateTime(void*, uint64_t); // the \void* argument is just a placeholder for function overload disambiguation
+	/* the inverse of \rawKey(); not public since arbitrary words can break the rule that n/a units make all shorter units n/a */
+	static DateTime fromRawKey(uint64_t key)   { return DateTime(nullptr, key); }
+	/* the whole object as one 64 bit word (ordered like the \DateTime values themselves); \memcpy keeps this free of strict aliasing problems */
+	uint64_t word() const       { uint64_t w;     std::memcpy(&w, this, sizeof w);     return w; }
+	void     word(uint64_t w)   { std::memcpy(this, &w, sizeof w); }
+	/* words with n/a year, month resp. day (and thus all shorter units); OR them into a word, time-of-day is left as it is */
+	constexpr static uint64_t INVALID = 0xFFFFFFFFF8000000; // all fields at ~0 except time-of-day, which is 0
+	constexpr static uint64_t NO_Y = 0xFFFFFFFFF8000000, NO_M = 0x0000000FF8000000, NO_D = 0x00000000F8000000;
 };
+static_assert(std::is_trivially_copyable<DateTime>::value, "DateTime must be trivially copyable");
 
 
 /**************************************************************************************************************************************************************/
@@ -192,6 +217,11 @@ inline constexpr DateTime::day_t DateTime::monthLength(year_t Y, month_t M) { //
 }
 // { return (M > 0 && M < 12 ? (M == 2 ? (isLeapYear(Y) ? 29 : 28) : (M + (M >> 3)) & 0b1) : 0); } // short, clever but probably slower
 
+inline constexpr DateTime::week_t DateTime::isoWeeksInYear(year_t Y) {
+	constexpr int64_t Y0 = DateTimeBase::floor400(int64_t(std::numeric_limits<year_t>::min()));
+	return static_cast<week_t>(DateTimeBase::isoWeeksInYear_(int64_t(Y) - Y0));
+}
+
 inline constexpr DateTime::dayOffset_t DateTime::dayOffset(year_t Y, month_t M, day_t D) {
 	if(D > monthLength(Y, M))   return NODAYOFFSET; // this simultaneously checks for illegal months and days
 	constexpr dayOffset_t y0 = DateTimeBase::floor400(dayOffset_t(std::numeric_limits<year_t>::min()));
@@ -201,34 +231,45 @@ inline constexpr DateTime::dayOffset_t DateTime::dayOffset(year_t Y, month_t M,
 inline constexpr DateTime::DateTime(year_t Y, month_t M, day_t D, timeOfDay_t T) :
 	DateTimeBase::curArchitectureBitFieldType<>(Y - minYear, M - 1, D - 1)
 {
-	using W = uint64_t;
-	if(Y < minYear || Y > maxYear)        *((W*)this) |= (((W)NODAY - 1) << 27) + (((W)NOMONTH - 1) << 32) + ((W)NOYEAR << 36);
-	else if(--M >= 12)                    *((W*)this) |= (((W)NODAY - 1) << 27) + (((W)NOMONTH - 1) << 32);
-	else if(--D >= monthLength(Y, ++M))   *((W*)this) |= (((W)NODAY - 1) << 27);
+	if(Y < minYear || Y > maxYear)        { d = NODAY - 1;     m = NOMONTH - 1;     y = NOYEAR; }
+	else if(--M >= 12)                    { d = NODAY - 1;     m = NOMONTH - 1; }
+	else if(--D >= monthLength(Y, ++M))     d = NODAY - 1;
 	if(T < maxTime)   t = T + 1;
 }
 
-inline constexpr DateTime::DateTime() : DateTimeBase::curArchitectureBitFieldType<>(NOYEAR + minYear, NOMONTH - 1, NODAY - 1) { }
+inline constexpr DateTime::DateTime() : DateTimeBase::curArchitectureBitFieldType<>(NOYEAR, NOMONTH - 1, NODAY - 1) { }
 
 inline constexpr DateTime::DateTime(dayOffset_t offs, timeOfDay_t T) :
-	DateTimeBase::curArchitectureBitFieldType<>(NOYEAR + minYear, NOMONTH - 1, NODAY - 1)
+	DateTimeBase::curArchitectureBitFieldType<>(NOYEAR, NOMONTH - 1, NODAY - 1)
 {
 	if(T < maxTime)   t = T + 1;
-	if(offs < minDayOffset || offs > maxDayOffset)   return; // offset outside storable range
-	// we pretend that all years have the same length, that will give the correct result in 99.76% of cases, and the previous year in the rest
-	dayOffset_t Y = ((offs -= minDayOffset) * 400) / 146097; // \dayOffset_t is large enough so that there can be no overflow here
+	if(offs < minDayOffset || offs > maxDayOffset)   { DATETIME_COUNT_CONSTEXPR(INVALID_INPUT);     return; } // offset outside storable range
+	// we pretend that all years have the same length, that will give the correct result in 99.83% of cases, and the previous year in the rest
+	// (since \minYear is a leap year, a year can start up to 1.48 days later than on average; shifting by half a day keeps the estimate from overshooting)
+	dayOffset_t Y = ((offs -= minDayOffset) * 400 - 200) / 146097; // \dayOffset_t is large enough so that there can be no overflow here
 	bool isLY = DateTimeBase::isLeapYear_(Y);
-	dayOffset_t offs2 = DateTimeBase::dayOffset_<minYear>(Y - minYear, 0, 0);
-	if((offs -= offs2) >= (isLY ? 366 : 365)) { // this happens in 0.24% of all cases
+	dayOffset_t offs2 = DateTimeBase::dayOffset_<minYear>(Y, 0, 0) - minDayOffset;
+	if((offs -= offs2) >= (isLY ? 366 : 365)) { // this happens in 0.17% of all cases
 		offs -= (isLY ? 366 : 365);
 		isLY = DateTimeBase::isLeapYear_(++Y);
-	} // now \offs is the offset inside the year
+		DATETIME_COUNT_CONSTEXPR(OFFSET_YEAR_CORRECTION);
+	} else DATETIME_COUNT_CONSTEXPR(OFFSET_DIRECT); // now \offs is the offset inside the year
 	y = Y;
 	m = DateTimeBase::dayInYear_(offs, isLY);
 	d = offs;
 }
 
 
+inline constexpr DateTime DateTime::fromIsoWeekDate(year_t Y, week_t W, Weekday wd) {
+	if(W < 1 || W > isoWeeksInYear(Y) || wd < Sunday || wd > Saturday)   return DateTime{};
+	constexpr int64_t Y0 = DateTimeBase::floor400(int64_t(std::numeric_limits<year_t>::min()));
+	const unsigned int j = (DateTimeBase::yearStartWeekday_(int64_t(Y) - Y0) + 6) % 7; // January 1st: 0 == Monday ... 6 == Sunday
+	// week 1 starts on the Monday on or before January 1st if that is a Monday...Thursday, otherwise on the Monday after it
+	const dayOffset_t monday1 = dayOffset(Y, 1, 1) - j + (j > 3 ? 7 : 0);
+	return DateTime{ monday1 + 7 * (W - 1) + (wd + 5) % 7 };
+}
+
+
 inline constexpr DateTime::year_t      DateTime::year()  const { return static_cast<year_t>(y) + minYear; }
 inline constexpr DateTime::month_t     DateTime::month() const { return m + 1; }
 inline constexpr DateTime::day_t       DateTime::day()   const { return d + 1; }
@@ -241,6 +282,21 @@ inline constexpr DateTime::dayInYear_t DateTime::dayInYear() const {
 inline constexpr DateTime::dayOffset_t DateTime::dayOffset() const
 	{ return (d != NODAY - 1 ? DateTimeBase::dayOffset_<minYear>(y, m, d) : NODAYOFFSET); }
 
+inline constexpr DateTime::week_t DateTime::isoWeek() const {
+	int dYear = 0;
+	return (d != NODAY - 1 ? DateTimeBase::isoWeek_<int64_t>(y, dayInYear() - 1, dYear) : 0);
+}
+inline constexpr DateTime::year_t DateTime::isoWeekYear() const {
+	int dYear = 0;
+	return (d != NODAY - 1 ? (DateTimeBase::isoWeek_<int64_t>(y, dayInYear() - 1, dYear), year() + dYear) : NOYEAR);
+}
+
 } /* end of namespace */
 
+#if DATETIME_HEADER_ONLY
+#	define DATETIME_INLINE inline
+#	include "DateTime.inl"
+#	undef DATETIME_INLINE
+#endif
+
 #undef PROJECT_NAMESPACE
@@ -0,0 +1,323 @@
+/* Definitions of the \DateTime member functions that are not \constexpr.                                                    */
+/* With \DATETIME_HEADER_ONLY this file is included by \DateTime.h and all functions are inline, otherwise DateTime.cpp compiles it. */
+/* \DATETIME_INLINE must be defined by the including file.                                                                          */
+
+#include <limits>
+#include <cmath>
+
+namespace PROJECT_NAMESPACE {
+
+
+DATETIME_INLINE bool DateTime::hasYear     () const { return y != (unsigned int)NOYEAR;  }
+DATETIME_INLINE bool DateTime::hasMonth    () const { return m != (unsigned int)NOMONTH - 1; }
+DATETIME_INLINE bool DateTime::hasDay      () const { return d != (unsigned int)NODAY   - 1; }
+DATETIME_INLINE bool DateTime::hasTime     () const { return t != 0; }
+DATETIME_INLINE bool DateTime::fullDateTime() const { return d != (unsigned int)NODAY - 1 && t != 0; }
+DATETIME_INLINE bool DateTime::isValid     () const { return d != (unsigned int)NODAY - 1; }
+DATETIME_INLINE DateTime::operator bool    () const { return d != (unsigned int)NODAY - 1; }
+
+DATETIME_INLINE bool DateTime::isLeapYear() const { return DateTimeBase::isLeapYear_(y); }
+
+DATETIME_INLINE DateTime::dayInYear_t DateTime::yearLength() const
+	{ return (y != NOYEAR ? (DateTimeBase::isLeapYear_(y) ? 366 : 365) : 0); }
+
+DATETIME_INLINE DateTime::day_t DateTime::monthLength() const
+	{ return monthLength(year(), m + 1); }
+
+DATETIME_INLINE DateTime::Weekday DateTime::weekday() const {
+	if(d == NODAY - 1)   return Weekday::NODAY;
+	// 400 years (146097 days) are whole weeks, so counting from year 400 instead of \minYear keeps the weekday and the offset positive;
+	// day offset 0 is a Monday
+	return static_cast<Weekday>(((DateTimeBase::dayOffset_<400>(y, m, d) + 1) % 7) + 1);
+}
+
+
+DATETIME_INLINE DateTime::DateTime(void*, uint64_t val) { word(val); }
+
+
+DATETIME_INLINE double DateTime::partOf24h() const { return (t - 1) / 86400000.; }
+
+/*
+double DateTime::years(FloatingPointConversionMode mode, bool includeTimeOfDay) const {
+	unsigned int x, x2;
+	if((x = m) == NOMONTH)   return ((x2 = y) == NOYEAR ? 0 : double(x2) + minYear);
+	double e = 0;
+	if(d != NODAY) {
+		if(includeTimeOfDay && t)   e += (t - 1) / 86400000.;
+		e += d;
+	}
+	x2 = y;
+	if(mode == EQUALDAYS) {
+		if(isLeapYear_(x2))
+					 (e += monthBeginsLY[x]) /= 366;
+		else   (e += monthBegins  [x]) /= 365;
+	} else {
+		e /= (isLeapYear_(x2) ? monthLengthsLY : monthLengths)[x]; // \e is now fraction of month
+		(e += x) /= 12;
+	}
+	return e += double(x2) + minYear;
+}
+
+
+#include <iostream>
+bool DateTime::years(double t, FloatingPointConversionMode mode, bool includeTimeOfDay) {
+	using std::floor;
+	if(t < double(minYear) - 2 || t > double(maxYear) + 2)   return false; // certainly outside range; otherwise the year can at least be stored by \year_t
+	year_t Y;     DY x, M;     DM z;
+	const DY* begins = nullptr;
+	if(!includeTimeOfDay)   switch(mode) {
+		case EQUALMONTHS:
+			Y = static_cast<year_t>(floor(t + .5 / 372)); // the last day of the year is always an 31th of a 12th (== 1/372) > year unambiguously determined
+			if(Y < minYear || Y > maxYear)   return false;
+			y = Y - minYear;
+			(t -= Y) *= 12;
+			M = static_cast<DY>(floor(t + .5 / 31)); // try with the longest month; we may mistakenly obtain the previous month
+			z = (isLeapYear_(Y) ? monthLengthsLY : monthLengths)[M];
+			if((x = static_cast<DY>(floor(((t -= M) *= z) + .5))) == z)   { m = ++M;     d = 0; }
+			else                                                          { m =   M;     d = x; }
+			break;
+		case EQUALDAYS:
+			t -= (Y = static_cast<year_t>(floor(t + .5 / 366))); // try with leap year first  they have shorter days, so perhaps we get the previous year instead
+			if(isLeapYear_(Y)) { M = 366;     begins = monthBeginsLY; }
+			else               { M = 365;     begins = monthBegins;   }
+			if((x = static_cast<DY>(floor((t *= M) + .5))) == M) { // Correction: it isn't the last day of a leap year, it's the first day of a year after a non-leap year.
+				if(++Y < minYear || Y > maxYear)   return false;
+				y = Y - minYear;     m = 0;     d = 0;     t = 0;
+				return true;
+			}
+			if(Y < minYear || Y > maxYear)   return false;
+			y = Y - minYear;
+			M = x >> 5;
+			if(x >= begins[M + 1])   ++M; // cf. \dayInYear(dayInYear_t)
+			d = x - begins[M];
+			m = M;
+		}
+	else { // this should be a lot simpler: we put the date where it falls, damn the rounding errors
+		Y = static_cast<year_t>(floor(t));
+		if(Y < minYear || Y > maxYear)   return false;
+		y = Y - minYear;
+		switch(mode) {
+		case EQUALMONTHS:
+			m = z = static_cast<DM>(floor((t -= Y) *= 12));
+			d = z = static_cast<DM>(floor((t -= z) *= monthLength(Y, z)));
+			partOf24h(t -= z);     break;
+		case EQUALDAYS:
+			dayInYear(M = static_cast<DY>(floor((t -= Y) *= yearLength(Y))));
+			partOf24h(t -= M);
+		}
+	}
+	return true;
+}*/
+
+
+
+DATETIME_INLINE bool DateTime::time(unsigned short* H, unsigned short* M, unsigned short* S, unsigned short* L) const {
+	unsigned int T = t;
+	if(T == 0)   return false;     else --T;
+	if(H)   T -= 3600000 * (*H = T / 3600000);     else T %= 3600000;
+	if(M)   T -=   60000 * (*M = T /   60000);     else T %=   60000;
+	if(S)   T -=    1000 * (*S = T /    1000);     else T %=    1000;
+	if(L)   *L = T;
+	return true;
+}
+
+
+
+DATETIME_INLINE bool DateTime::set(year_t Y) {
+	if(Y < minYear || Y > maxYear)   { word(word() | NO_Y);     return false; } // leaves time-of-day unchanged
+	y = Y - minYear;
+	word(word() & 0xFFFFFFF007FFFFFF); // remove month and day (i.e. set them to 1-1)
+	return true;
+}
+DATETIME_INLINE bool DateTime::set(year_t Y, month_t M) {
+	if(Y < minYear || Y > maxYear)   { word(word() | NO_Y);     return false; } // leaves time-of-day unchanged
+	y = Y - minYear;
+	if(--M >= 12)                    { word(word() | NO_M);     return false; }
+	m = M;
+	word(word() & 0xFFFFFFFF07FFFFFF); // set day to 1
+	return true;
+}
+DATETIME_INLINE bool DateTime::set(year_t Y, month_t M, day_t D) {
+	if(Y < minYear || Y > maxYear)   { word(word() | NO_Y);     return false; } // leaves time-of-day unchanged
+	y = Y - minYear;
+	if(--M >= 12)                    { word(word() | NO_M);     return false; }
+	m = M;
+	if(--D >= monthLength())         { word(word() | NO_D);     return false; }
+	d = D;
+	return true;
+}
+
+
+
+DATETIME_INLINE bool DateTime::year(year_t Y) {
+	if(Y < minYear || Y > maxYear)             { word(word() | NO_Y);     return false; }
+	word(word() & 0xFFFFFFF007FFFFFF); // remove month and day (i.e. set them to 1-1)
+	y = Y - minYear;     return true;
+}
+DATETIME_INLINE bool DateTime::month(month_t M) {
+	if(y == NOYEAR || --M >= 12)               { word(word() | NO_M);     return false; }
+	word(word() & 0xFFFFFFFF07FFFFFF); // set day to 1
+	m = M;     return true;
+}
+DATETIME_INLINE bool DateTime::day(day_t D) {
+	if(m == NOMONTH || --D >= monthLength())   { word(word() | NO_D);     return false; } // no year implies no month
+	d = D;     return true;
+}
+
+
+DATETIME_INLINE bool DateTime::time(timeOfDay_t T) {
+	if(T < maxTime)   { t = ++T;     return true;  }
+	else              { t = 0;       return false; }
+}
+DATETIME_INLINE bool DateTime::time(unsigned short H, unsigned short M, unsigned short S, unsigned short MS) {
+	constexpr timeOfDay_t maxH = maxTime / (60 * 60 * 1000);
+	if(MS >= 1000 || S >= 60 || M >= 60 || H >= maxH)   { t = 0;                                           return false; }
+	else                                                { t = 1 + MS + 1000 * (S + 60 * (M + 60 * H));     return true;  }
+}
+DATETIME_INLINE bool DateTime::time(unsigned short H, unsigned short M, double S) {
+	constexpr timeOfDay_t maxH = maxTime / (60 * 60 * 1000);
+	if(S < 0 || S >= 60 || M >= 60 || H >= maxH)   { t = 0;                                                           return false; }
+	else                                           { t = (timeOfDay_t(2000 * S + 3) >> 1) + 60000 * (M + 60 * H);     return true;  }
+}
+DATETIME_INLINE bool DateTime::partOf24h(double T) {
+	constexpr timeOfDay_t maxH = maxTime / (60 * 60 * 1000);
+	if(T < 0 || T >= maxH / 24.) { t = 0;                                       return false; }
+	else                         { t = timeOfDay_t(T * 172800000 + 3) >> 1;     return true;  } // round to the nearest millisecond
+}
+DATETIME_INLINE void DateTime::unsetTime() { t = 0; }
+
+
+DATETIME_INLINE bool DateTime::isMonthFirst() const { return d == 0; }
+
+// since invalid days are 0x1F==31 and \monthLength() of invalud months is always 0 the function returns false if any fiels is nAn
+DATETIME_INLINE bool DateTime::isMonthLast()  const { return d + 1 == monthLength(); }
+
+
+DATETIME_INLINE DateTime DateTime::monthFirst() const { return DateTime(nullptr,  word() & (m != NOMONTH - 1 ? 0xFFFFFFFF00000000 : INVALID)); }
+DATETIME_INLINE DateTime DateTime::monthLast () const { return DateTime(nullptr, (word() & (m != NOMONTH - 1 ? 0xFFFFFFFF00000000 : INVALID)) | (uint64_t(monthLength() - 1) << 27)); }
+DATETIME_INLINE DateTime DateTime::yearFirst () const { return DateTime(nullptr,  word() & (y != NOYEAR      ? 0xFFFFFFF000000000 : INVALID)); }
+DATETIME_INLINE DateTime DateTime::yearLast  () const { return DateTime(nullptr, (word() & (y != NOYEAR      ? 0xFFFFFFF000000000 : INVALID)) | 0x0000000BF0000000); }
+
+
+DATETIME_INLINE bool DateTime::dayInYear(dayInYear_t dY) {
+	if(y == NOYEAR)   return false;
+	m = DateTimeBase::dayInYear_(dY, DateTimeBase::isLeapYear_(y));
+	return (d = dY) != NODAY - 1;
+}
+
+
+DATETIME_INLINE bool DateTime::dayOffset(dayOffset_t dt) {
+	operator=(DateTime{ dt });
+	return (d != NODAY - 1);
+}
+
+
+DATETIME_INLINE bool DateTime::operator==(const DateTime& d) const { return word() == d.word(); }
+DATETIME_INLINE bool DateTime::operator!=(const DateTime& d) const { return word() != d.word(); }
+DATETIME_INLINE bool DateTime::operator< (const DateTime& d) const { return word() <  d.word(); }
+DATETIME_INLINE bool DateTime::operator> (const DateTime& d) const { return word() >  d.word(); }
+DATETIME_INLINE bool DateTime::operator<=(const DateTime& d) const { return word() <= d.word(); }
+DATETIME_INLINE bool DateTime::operator>=(const DateTime& d) const { return word() >= d.word(); }
+
+
+
+DATETIME_INLINE DateTime& DateTime::operator+=(dayOffset_t dt) {
+	if(dt < 0)   return operator-=(-dt);
+	if(d == NODAY)   return *this;
+	// simplified calculation for offsets that stay in the same year
+	static constexpr dayInYear_t monthBegins   []{ 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365 },
+	                             monthBeginsLY []{ 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366 };
+	if(dt < 366) { // first a rough check to ensure no overflow
+		dayOffset_t dt2 = dt + d;
+		if(DateTimeBase::isLeapYear_(y)) {
+			if((dt2 += monthBeginsLY[m]) < 366) {
+				month_t mo = static_cast<month_t>(dt2 >> 5);
+				if(dt2 >= monthBeginsLY[mo + 1])   ++mo;
+				d = dt2 - monthBeginsLY[mo];     m = mo;
+				DATETIME_COUNT(ADD_SAME_YEAR);
+				return *this;
+			}
+		} else if((dt2 += monthBegins[m]) < 365) {
+			month_t mo = static_cast<month_t>(dt2 >> 5);
+			if(dt2 >= monthBegins[mo + 1])   ++mo;
+			d = dt2 - monthBegins[mo];     m = mo;
+			DATETIME_COUNT(ADD_SAME_YEAR);
+			return *this;
+		}
+	}
+	DATETIME_COUNT(ADD_ROUNDTRIP);
+	if(dt > maxDayOffset - minDayOffset || (dt += dayOffset()) > maxDayOffset) // offset too large > make date invalid
+		{ word(NO_Y);     DATETIME_COUNT(INVALID_RESULT);     return *this; }
+	dayOffset(dt);
+	return *this;
+}
+
+DATETIME_INLINE DateTime& DateTime::operator-=(dayOffset_t) { return *this; }
+
+
+DATETIME_INLINE DateTime  DateTime::operator+ (dayOffset_t doff) const
+	{ return DateTime{ *this } += doff; }
+DATETIME_INLINE DateTime  DateTime::operator- (dayOffset_t doff) const
+	{ return DateTime{ *this } -= doff; }
+
+
+DATETIME_INLINE DateTime& DateTime::operator++() {
+	unsigned int D = d;
+	if(D == NODAY)   return *this;
+	if(D < 27 || D < static_cast<unsigned int>(monthLength() - 1))   { d = ++D;   DATETIME_COUNT(INCREMENT_IN_MONTH);     return *this; }
+	d = 0;
+	if(++m < 12)   { DATETIME_COUNT(INCREMENT_MONTH_ROLLOVER);     return *this; }
+	DATETIME_COUNT(INCREMENT_YEAR_ROLLOVER);
+	if(++y == NOYEAR)   { word(word() | INVALID);     DATETIME_COUNT(INVALID_RESULT); }
+	m = 0;
+	return *this;
+}
+DATETIME_INLINE DateTime& DateTime::operator--() {
+	unsigned int D = d;
+	if(D == NODAY)   return *this;
+	if(D)   { d = --D;     return *this; }
+	if(m)   { --m;     d = static_cast<day_t>(monthLength() - 1);     return *this; }
+	if(y-- == 0)   { word(word() | INVALID);     DATETIME_COUNT(INVALID_RESULT);     return *this; }
+	m = 11;     d = 30;
+	return *this;
+}
+
+DATETIME_INLINE DateTime DateTime::operator++(int) const
+	{ return ++DateTime{ *this }; }
+DATETIME_INLINE DateTime DateTime::operator--(int) const
+	{ return --DateTime{ *this }; }
+
+
+
+// number of days from one date to another (disregarding time-of-day)
+DATETIME_INLINE DateTime::dayOffset_t DateTime::operator-(const DateTime& DT) const
+	{ return dayOffset() - DT.dayOffset(); }
+
+
+
+/*int DateTime::parse(const char* s) {
+	using DOT = DateTime::dayOffset_t;
+	constexpr DOT maxDayOffs = static_cast<DOT>(DateTime::maxYear) * 10000 + 1231;
+	struct { DOT val;     int nDigits; } data[4];
+
+	int i = 0;
+	char c;
+	while(c = *s) {
+		if(c >= '0' && c <= '9') {
+			auto& d = data[i++];
+			for(d.val = d.nDigits = 0, --s;     (c = *++s) >= '0' && c <= '9'; ) {
+				if(((d.val *= 10) += c - '0') > maxDayOffs)   return false; // overflow
+				++d.nDigits;
+			}
+			if(c != ':' && i < 3)   continue;
+			if(c == ':')   --i;
+			// so 
+				if(i > 1) // 
+
+			}
+		}
+	}
+}
+*/
+
+} /* end of namespace */
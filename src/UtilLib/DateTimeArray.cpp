@@ -0,0 +1,96 @@
+#include "DateTimeArray.h"
+#include "Version.h"
+
+#include <cstring>
+
+using namespace PROJECT_NAMESPACE;
+
+using DO = DateTime::dayOffset_t;
+using YT = DateTime::year_t;
+using WT = DateTime::week_t;
+
+namespace {
+	/* The loops below read each \DateTime as one 64 bit word (year in bits 36...63, month in 32...35, day in 27...31) and */
+	/* do all arithmetic on 32 bit unsigned ints; unlike bit field accesses and 64 bit divisions this vectorises.          */
+	struct Fields {
+		uint32_t Y, dY; // year counted from \DateTime::minYear, day-in-year 0...365
+		bool     valid;
+	};
+
+	inline Fields fields(const DateTime& D) {
+		const uint64_t w = D.rawKey();
+		const uint32_t Y = uint32_t(w >> 36), M = (uint32_t(w >> 32) & 0x0F) + 1, d = uint32_t(w >> 27) & 0x1F;
+		const uint32_t isLY = DateTimeBase::isLeapYear_(Y);
+		return { Y, 30 * M + ((M + (M >> 3)) >> 1) - (M > 2 ? 32 - isLY : 30) + d, d != DateTime::NODAY - 1 }; // cf. \DateTime::dayInYear()
+	}
+
+	// \fromDayOffsets() counts years from March 1st (so the leap day comes last), starting one 400 year cycle early
+	// so that January and February of \minYear aren't negative
+	constexpr DO marchOffset   = DateTime::dayOffset(DateTime::minYear - 400, 3, 1);
+} /* end of anonymous namespace */
+
+
+void PROJECT_NAMESPACE::dayOffsets(const DateTime* in, size_t n, DO* offsets) {
+	for(size_t i = 0;     i < n;     ++i) {
+		const Fields F = fields(in[i]);
+		const uint32_t c = F.Y / 400, yc = F.Y % 400; // the cycles start with a leap year, since \minYear is divisible by 400
+		const uint32_t dC = 365 * yc + (yc + 3) / 4 - (yc + 99) / 100 + (yc + 399) / 400 + F.dY;
+		const DO mask = -DO(F.valid); // a select here would stop vectorisation
+		offsets[i] = ((DateTime::minDayOffset + DO(c) * 146097 + dC) & mask) | (DateTime::NODAYOFFSET & ~mask);
+	}
+}
+
+
+// Everything here is 32 bit or plain 64 bit bit-twiddling, which SSE2 has: the range test compares the two halves of the offset
+// separately, and the 400 year cycles are split off in double precision, with the offset converted by the usual 2^52 trick
+void PROJECT_NAMESPACE::fromDayOffsets(const DO* offsets, size_t n, DateTime* out) {
+	constexpr uint64_t range = uint64_t(DateTime::maxDayOffset - DateTime::minDayOffset);
+	constexpr uint32_t rangeH = uint32_t(range >> 32), rangeL = uint32_t(range);
+	constexpr uint64_t two52 = uint64_t(1) << 52, two52Bits = uint64_t(0x433) << 52; // bits of \{double(2^52)}
+	const uint64_t na = DateTime{}.rawKey();
+	for(size_t i = 0;     i < n;     ++i) {
+		const uint64_t u = uint64_t(offsets[i]) - uint64_t(DateTime::minDayOffset);           // wraps around below \minDayOffset
+		const uint32_t uH = uint32_t(u >> 32), uL = uint32_t(u);
+		const bool valid = (uH < rangeH) | ((uH == rangeH) & (uL <= rangeL));
+		const uint64_t mask = uint64_t(0) - valid;                                            // a select here would stop vectorisation
+		const uint64_t z = (u & mask) + uint64_t(DateTime::minDayOffset - marchOffset);        // < 2^52
+		uint64_t zBits = z | two52Bits;
+		double zD;
+		std::memcpy(&zD, &zBits, sizeof zD);
+		const uint32_t c   = uint32_t(int32_t((zD - double(two52)) / 146097));                 // 400 year cycles
+		const uint32_t dC  = uint32_t(z) - c * 146097;                                        // day in cycle
+		// the rest follows Neri & Schneider, "Euclidean affine functions and their application to calendar algorithms" (2022):
+		// multiplications and shifts replace most divisions, and the 32x32->64 bit multiplication is native to SSE2
+		const uint32_t n1  = 4 * dC + 3, cent = n1 / 146097, dCent = (n1 % 146097) / 4;      // century in cycle, day in century
+		const uint64_t p2  = uint64_t(4 * dCent + 3) * 2939745;
+		const uint32_t yCent = uint32_t(p2 >> 32), dY = uint32_t(p2) / 11758980;             // year in century, day in year from March 1st
+		const uint32_t n3  = 2141 * dY + 197913;
+		const uint32_t mp  = n3 >> 16, d = (n3 & 0xFFFF) / 2141;                             // month 3...14, 0-based day
+		const uint32_t J   = (dY >= 306), m = mp - 1 - 12 * J;                              // January and February belong to the next year
+		const uint32_t Y   = c * 400 + cent * 100 + yCent + J - 400;                        // counted from \minYear
+		const uint64_t w   = ((uint64_t(Y) << 36 | uint64_t(m) << 32 | uint64_t(d) << 27) & mask) | (na & ~mask);
+		std::memcpy(static_cast<void*>(out + i), &w, sizeof w);
+	}
+}
+
+
+void PROJECT_NAMESPACE::isoWeeks(const DateTime* in, size_t n, WT* weeks) {
+	for(size_t i = 0;     i < n;     ++i) {
+		const Fields F = fields(in[i]);
+		int dYear;
+		const WT W = DateTimeBase::isoWeek_(F.Y, F.dY, dYear);
+		weeks[i] = (F.valid ? W : 0);
+	}
+}
+
+
+void PROJECT_NAMESPACE::isoWeekDates(const DateTime* in, size_t n, YT* weekYears, WT* weeks) {
+	for(size_t i = 0;     i < n;     ++i) {
+		const Fields F = fields(in[i]);
+		int dYear;
+		const WT W = DateTimeBase::isoWeek_(F.Y, F.dY, dYear);
+		const uint32_t mask = 0u - F.valid; // selects would stop vectorisation
+		weeks    [i] = WT(W & mask);
+		weekYears[i] = YT((uint32_t(YT(F.Y) + DateTime::minYear + dYear) & mask) | (uint32_t(DateTime::NOYEAR) & ~mask));
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "DateTime.h"
+#include "Version.h"
+
+#include <cstddef>
+
+namespace PROJECT_NAMESPACE {
+
+/* Functions working on whole arrays of \DateTime. Their loop bodies are branch-free and use no 64 bit comparisons or           */
+/* conversions, so the compiler vectorises them with plain SSE2, i.e. without a -march option.                                  */
+
+/* Day offsets, \{offsets[i] == in[i].dayOffset()} (\DateTime::NODAYOFFSET for n/a days) */
+void dayOffsets(const DateTime* in, size_t n, DateTime::dayOffset_t* offsets);
+/* The inverse, \{out[i] == DateTime{ offsets[i] }}; offsets outside the range of \DateTime give n/a dates */
+void fromDayOffsets(const DateTime::dayOffset_t* offsets, size_t n, DateTime* out);
+/* ISO 8601 week numbers, \{weeks[i] == in[i].isoWeek()} */
+void isoWeeks(const DateTime* in, size_t n, DateTime::week_t* weeks);
+/* ISO 8601 week-years and week numbers in one pass, \{weekYears[i] == in[i].isoWeekYear()}, \{weeks[i] == in[i].isoWeek()} */
+void isoWeekDates(const DateTime* in, size_t n, DateTime::year_t* weekYears, DateTime::week_t* weeks);
+
+} /* end of namespace */
+
+#undef PROJECT_NAMESPACE
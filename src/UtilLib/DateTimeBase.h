@@ -37,7 +37,8 @@ namespace DateTimeBase {
 	// a few static helper functions for \DateTime below
 	template<typename T>
 	static constexpr T floor400(T t) { return (t >= 0 ? t / 400 : -((T(399) - t) / 400)) * 400; }
-	static constexpr bool isLeapYear_(int64_t Y) { return !(Y & 0x03) && ((Y % 100) || !(Y & 0x0F)); } // \Y must be nonnegative
+	template<typename T>
+	static constexpr bool isLeapYear_(T Y) { return ((Y & 0x03) == 0) & ((Y % 100 != 0) | ((Y & 0x0F) == 0)); } // \Y must be nonnegative; no short-circuits, so loops stay vectorisable
 	template<int64_t y0> // number of days from 00010101 to the date (Y+y0)(M-1)(D-1);   y0 must be divisible by 400
 	constexpr static int64_t dayOffset_(int64_t Y, unsigned char M, unsigned char D) { // \Y >= 0, \M is 0...12, \D is 0...30
 		// All this rigmarole with offsets is so that we can use bit shifts instead of division to improve performance;
@@ -47,6 +48,21 @@ namespace DateTimeBase {
 		int64_t e = offs + D + (M <= 1 ? (Y += 399, M * 31) : (Y += 400, 30 * M + ((M + 1 + (M >> 3)) >> 1) - 367));
 		return e += Y * 365 + (Y >> 2) - (3 * (Y / 100 + 1) >> 2);
 	}
+	// weekday of January 1st (0 == Sunday ... 6 == Saturday) by Gauss' formula; like \isLeapYear_ this needs \Y >= 0 and counted from a year divisible by 400
+	// The ISO week helpers are templates so that the array functions can run them on \uint32_t (enough for the 28 bit year field), which vectorises
+	template<typename T>
+	static constexpr T yearStartWeekday_(T Y) { Y += 399;     return (1 + 5 * (Y & 0x03) + 4 * (Y % 100) + 6 * (Y % 400)) % 7; }
+	template<typename T> // ISO years starting on a Thursday, and leap years starting on a Wednesday, have 53 weeks
+	static constexpr T isoWeeksInYear_(T Y) { const T j = yearStartWeekday_(Y);     return 52 + ((j == 4) | ((j == 3) & isLeapYear_(Y))); }
+	// ISO 8601 week of day \dY (0...365) of year \Y; \dYear receives the difference (-1, 0, +1) between the ISO week-year and \Y
+	template<typename T>
+	static constexpr unsigned char isoWeek_(T Y, T dY, int& dYear) {
+		const T wd = (yearStartWeekday_(Y) + dY + 6) % 7; // 0 == Monday ... 6 == Sunday
+		const T W  = (dY + 10 - wd) / 7;
+		const T prevWeeks = isoWeeksInYear_(T(Y + 399)); // \Y + 399 is the previous year modulo 400
+		dYear = (W == 0 ? -1 : (W == 53 && isoWeeksInYear_(Y) == 52 ? 1 : 0));
+		return static_cast<unsigned char>(W == 0 ? prevWeeks : (dYear ? 1 : W));
+	}
 	template<typename T>
 	constexpr unsigned char dayInYear_(T& offs, bool isLY) { // returns the month, sets \offs to day-of-month
 		unsigned char M = static_cast<unsigned char>(offs >> 5); // division by 32 > the correct month or the one before it (actually Y holds the next month)
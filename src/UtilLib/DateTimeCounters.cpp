@@ -0,0 +1,40 @@
+#include "DateTimeCounters.h"
+#include "Version.h"
+
+#include <ostream>
+#include <iomanip>
+
+using namespace PROJECT_NAMESPACE;
+using namespace PROJECT_NAMESPACE::DateTimeCounters;
+
+
+const char* DateTimeCounters::name(Counter c) {
+	switch(c) {
+	case OFFSET_DIRECT:              return "offset ctor, direct";
+	case OFFSET_YEAR_CORRECTION:     return "offset ctor, year correction";
+	case ADD_SAME_YEAR:              return "operator+=, same year";
+	case ADD_ROUNDTRIP:              return "operator+=, day offset round trip";
+	case INCREMENT_IN_MONTH:         return "operator++, in month";
+	case INCREMENT_MONTH_ROLLOVER:   return "operator++, month rollover";
+	case INCREMENT_YEAR_ROLLOVER:    return "operator++, year rollover";
+	case INVALID_RESULT:             return "invalid result";
+	case INVALID_INPUT:              return "offset ctor, input out of range";
+	default:                         return "?";
+	}
+}
+
+
+#if DATETIME_INSTRUMENT
+Snapshot DateTimeCounters::snapshot() { return threadCounters(); }
+void     DateTimeCounters::reset()    { threadCounters() = Snapshot{}; }
+#else
+Snapshot DateTimeCounters::snapshot() { return Snapshot{}; }
+void     DateTimeCounters::reset()    { }
+#endif
+
+
+void DateTimeCounters::dump(std::ostream& os, const Snapshot& S) {
+	if(!enabled)   { os << "[DateTime counters not compiled in, configure with -DDATETIME_INSTRUMENT=ON]\n";     return; }
+	for(unsigned char i = 0;     i < N_COUNTERS;     ++i)
+		os << "  " << std::left << std::setw(36) << name(Counter(i)) << std::right << std::setw(14) << S.n[i] << '\n';
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Version.h"
+
+#include <cstdint>
+#include <iosfwd>
+
+/* Optional instrumentation of the fast and slow paths inside \DateTime.                                                         */
+/* Configure with -DDATETIME_INSTRUMENT=ON to compile in per-thread hit counters; otherwise \DATETIME_COUNT expands to nothing    */
+/* and the snapshot functions below return all zeros.                                                                            */
+/* Like \DateTimeBase.h this header is included by \DateTime.h and therefore must not undefine \PROJECT_NAMESPACE.               */
+
+namespace PROJECT_NAMESPACE {
+namespace DateTimeCounters {
+
+	enum Counter : unsigned char {
+		OFFSET_DIRECT,            // DateTime(dayOffset_t): the year estimate was correct
+		OFFSET_YEAR_CORRECTION,   // DateTime(dayOffset_t): the 0.17% branch that moves on to the following year
+		ADD_SAME_YEAR,            // operator+=: result found without leaving the year
+		ADD_ROUNDTRIP,            // operator+=: round trip through \dayOffset()
+		INCREMENT_IN_MONTH,       // operator++: day field incremented only
+		INCREMENT_MONTH_ROLLOVER, // operator++: move to the first of the next month
+		INCREMENT_YEAR_ROLLOVER,  // operator++: move to January 1st of the next year
+		INVALID_RESULT,           // any of the above operations produced an invalid date from valid input
+		INVALID_INPUT,            // DateTime(dayOffset_t): the offset was outside the storable range, the result is n/a
+		N_COUNTERS
+	};
+
+	constexpr bool enabled = (DATETIME_INSTRUMENT != 0);
+
+	struct Snapshot {
+		uint64_t n[N_COUNTERS];
+		uint64_t operator[](Counter c) const { return n[c]; }
+	};
+
+	const char* name(Counter);
+
+	Snapshot snapshot(); // counter values of the calling thread
+	void     reset();    // sets the counters of the calling thread to zero
+	void     dump(std::ostream&, const Snapshot&);
+	inline void dump(std::ostream& os)   { dump(os, snapshot()); }
+
+#if DATETIME_INSTRUMENT
+	inline Snapshot& threadCounters() {
+		static thread_local Snapshot S{};
+		return S;
+	}
+#endif
+
+} /* end of namespace DateTimeCounters */
+} /* end of project namespace*/
+
+/* \DATETIME_COUNT is for ordinary functions. \constexpr functions use \DATETIME_COUNT_CONSTEXPR, which doesn't count during constant */
+/* evaluation; telling that apart needs \std::is_constant_evaluated() from C++20, so instrumented builds are compiled as C++20 and  */
+/* before C++20 the counters in \constexpr functions stay at zero.                                                                   */
+#if DATETIME_INSTRUMENT
+#	define DATETIME_COUNT(c) void(++PROJECT_NAMESPACE::DateTimeCounters::threadCounters().n[PROJECT_NAMESPACE::DateTimeCounters::c])
+#	if __cplusplus >= 202002L
+#		include <type_traits>
+#		define DATETIME_COUNT_CONSTEXPR(c) (std::is_constant_evaluated() ? void() : DATETIME_COUNT(c))
+#	else
+#		define DATETIME_COUNT_CONSTEXPR(c) ((void)0)
+#	endif
+#else
+#	define DATETIME_COUNT(c) ((void)0)
+#	define DATETIME_COUNT_CONSTEXPR(c) ((void)0)
+#endif
@@ -0,0 +1,180 @@
+#include "DateTimeMerge.h"
+#include "Version.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+using namespace PROJECT_NAMESPACE;
+
+
+
+DateTimeArrayReader::DateTimeArrayReader(const DateTime* data, size_t n, size_t blockSize) :
+	data(data),   n(n),   blockSize(blockSize ? blockSize : n)
+{ }
+
+size_t DateTimeArrayReader::next(const DateTime*& block) {
+	const size_t m = std::min(n, blockSize);
+	block = data;
+	data += m;     n -= m;
+	return m;
+}
+
+
+DateTimeFileReader::DateTimeFileReader(const char* path, size_t blockSize) :
+	file(std::fopen(path, "rb")),   buffer(blockSize ? blockSize : 1)
+{ }
+
+DateTimeFileReader::~DateTimeFileReader() {
+	if(file)   std::fclose(file);
+}
+
+size_t DateTimeFileReader::next(const DateTime*& block) {
+	block = buffer.data();
+	return (file ? std::fread(buffer.data(), sizeof(DateTime), buffer.size(), file) : 0);
+}
+
+
+DateTimeMappedReader::DateTimeMappedReader(const char* path) {
+#if defined(_WIN32)
+	const HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if(f == INVALID_HANDLE_VALUE)   return;
+	LARGE_INTEGER size;
+	if(GetFileSizeEx(f, &size)) {
+		opened = true;
+		n = size_t(size.QuadPart) / sizeof(DateTime);
+		const HANDLE m = (n ? CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr);
+		if(m) { // the view keeps the mapping alive after the handles are closed
+			data = static_cast<const DateTime*>(MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0));
+			CloseHandle(m);
+		}
+		if(n && !data)   { opened = false;     n = 0; }
+	}
+	CloseHandle(f);
+#else
+	const int f = ::open(path, O_RDONLY);
+	if(f < 0)   return;
+	struct stat st;
+	if(!::fstat(f, &st)) {
+		opened = true;
+		n = size_t(st.st_size) / sizeof(DateTime);
+		if(n) {
+			void* p = ::mmap(nullptr, n * sizeof(DateTime), PROT_READ, MAP_PRIVATE, f, 0);
+			if(p != MAP_FAILED)   { ::madvise(p, n * sizeof(DateTime), MADV_SEQUENTIAL);     data = static_cast<const DateTime*>(p); }
+			else                  { opened = false;     n = 0; }
+		}
+	}
+	::close(f); // the mapping stays valid
+#endif
+}
+
+DateTimeMappedReader::~DateTimeMappedReader() {
+	if(!data)   return;
+#if defined(_WIN32)
+	UnmapViewOfFile(data);
+#else
+	::munmap(const_cast<DateTime*>(data), n * sizeof(DateTime));
+#endif
+}
+
+size_t DateTimeMappedReader::next(const DateTime*& block) {
+	block = data;
+	if(done)   return 0;
+	done = true;
+	return n;
+}
+
+
+
+constexpr uint64_t DateTimeMerger::END;
+
+DateTimeMerger::DateTimeMerger(DateTimeReader* const* streams, size_t k) {
+	while(leaves < k)   leaves *= 2;
+	heads  .assign(leaves, END);
+	cursors.resize(leaves);
+	tree   .resize(leaves);
+	for(size_t s = 0;     s < k;     ++s)   { cursors[s].reader = streams[s];     refill(uint32_t(s)); }
+
+	// play all matches bottom-up; \winners[leaves + s] is leaf \s, \winners[p] the winner below inner node \p
+	std::vector<uint32_t> winners(2 * leaves);
+	for(size_t s = 0;     s < leaves;     ++s)   winners[leaves + s] = uint32_t(s);
+	for(size_t p = leaves - 1;     p > 0;     --p) {
+		const uint32_t a = winners[2 * p], b = winners[2 * p + 1];
+		winners[p] = (less(b, a) ? b : a);
+		tree   [p] = (less(b, a) ? a : b);
+	}
+	tree[0] = winners[1];
+}
+
+
+void DateTimeMerger::refill(uint32_t s) {
+	Cursor& c = cursors[s];
+	const DateTime* block = nullptr;
+	const size_t m = c.reader->next(block);
+	c.pos = block;
+	c.end = block + m;
+	heads[s] = (m ? block->rawKey() : END);
+}
+
+
+// stream \s has a new head: walk up from its leaf, leaving the loser of each match behind
+void DateTimeMerger::replay(uint32_t s) {
+	for(size_t p = (leaves + s) / 2;     p > 0;     p /= 2) { // branch-free, since the outcome of each match is unpredictable
+		const uint32_t t = tree[p];
+		const bool     l = less(t, s);
+		tree[p] = (l ? s : t);
+		s       = (l ? t : s);
+	}
+	tree[0] = s;
+}
+
+
+// the largest key that stream \w (the current winner) may emit before it has to yield: the best competitor is the smallest of
+// the losers on the winner's path, and on equal keys the lower stream index goes first
+uint64_t DateTimeMerger::runLimit(uint32_t w) const {
+	uint32_t r = w;
+	for(size_t p = (leaves + w) / 2;     p > 0;     p /= 2) {
+		const uint32_t t = tree[p];
+		r = ((r == w) | less(t, r) ? t : r);
+	}
+	return (r == w || heads[r] == END ? END : heads[r] - (r < w));
+}
+
+
+// A stream is drained as a run only when it has won twice in a row; for streams that interleave closely it isn't worth
+// looking for the best competitor. Values equal to the winner's head can always go out, since equal heads of streams
+// with lower indices would have won.
+size_t DateTimeMerger::next(DateTime* out, uint32_t* streamIx, size_t n) {
+	size_t o = 0;
+	while(o < n) {
+		const uint32_t w = tree[0];
+		if(heads[w] == END)   break;
+		const uint64_t limit = (w == last ? runLimit(w) : heads[w]);
+		last = w;
+		Cursor& c = cursors[w];
+		for(;;) {
+			const DateTime* p = c.pos;
+			const DateTime* e = (size_t(c.end - p) > n - o ? p + (n - o) : c.end);
+			while(p < e && p->rawKey() <= limit)   ++p;
+			std::copy(c.pos, p, out + o);
+			if(streamIx)   std::fill(streamIx + o, streamIx + o + (p - c.pos), w);
+			o += p - c.pos;
+			c.pos = p;
+			if(p < c.end)   { heads[w] = p->rawKey();     break; }
+			refill(w);
+			if(heads[w] == END || heads[w] > limit || o == n)   break;
+		}
+		replay(w);
+	}
+	return o;
+}
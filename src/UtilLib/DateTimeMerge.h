@@ -0,0 +1,104 @@
+#pragma once
+
+#include "DateTime.h"
+#include "Version.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace PROJECT_NAMESPACE {
+
+/* K-way merge of sorted \DateTime streams into one chronological stream.                                                        */
+/* Streams are read block by block through \DateTimeReader, so they can live in memory, in files, or in memory-mapped files.     */
+
+/* Source of one sorted stream. \next() points \block at the next block of values and returns its length, 0 at the end of the */
+/* stream. The block must stay valid until the following call of \next(), so readers over memory can hand out their data       */
+/* without copying.                                                                                                            */
+class DateTimeReader {
+public:
+	virtual ~DateTimeReader() = default;
+	virtual size_t next(const DateTime*& block) = 0;
+};
+
+/* Stream over an array in memory, handed out in blocks of \blockSize values (0: all at once) */
+class DateTimeArrayReader : public DateTimeReader {
+public:
+	DateTimeArrayReader(const DateTime* data, size_t n, size_t blockSize = 0);
+	size_t next(const DateTime*& block) override;
+private:
+	const DateTime* data;
+	size_t n, blockSize;
+};
+
+/* Stream over a file holding a plain \DateTime array (as written by \fwrite), read in blocks of \blockSize values */
+class DateTimeFileReader : public DateTimeReader {
+public:
+	explicit DateTimeFileReader(const char* path, size_t blockSize = 4096);
+	~DateTimeFileReader();
+	DateTimeFileReader(const DateTimeFileReader&) = delete;
+	DateTimeFileReader& operator=(const DateTimeFileReader&) = delete;
+
+	bool isOpen() const   { return file != nullptr; }
+	size_t next(const DateTime*& block) override;
+private:
+	std::FILE* file;
+	std::vector<DateTime> buffer;
+};
+
+/* Same file format as \DateTimeFileReader, but the file is mapped into memory and handed out as one block without copying */
+class DateTimeMappedReader : public DateTimeReader {
+public:
+	explicit DateTimeMappedReader(const char* path);
+	~DateTimeMappedReader();
+	DateTimeMappedReader(const DateTimeMappedReader&) = delete;
+	DateTimeMappedReader& operator=(const DateTimeMappedReader&) = delete;
+
+	bool isOpen() const   { return opened; }
+	size_t next(const DateTime*& block) override;
+private:
+	const DateTime* data = nullptr;
+	size_t n = 0;
+	bool opened = false, done = false;
+};
+
+
+/* The merge runs a loser tree over the raw 64 bit keys (\DateTime::rawKey()) of the stream heads, so each value costs about   */
+/* log2(number of streams) integer comparisons. Equal values come out in the order of their stream indices, so the merge is   */
+/* stable. When a stream wins twice in a row it is drained as a run for as long as its head stays below the best competitor,   */
+/* which costs one comparison per value; only then is the tree replayed.                                                       */
+/* The readers are not owned and must outlive the merger. At most 2^32 - 1 streams.                                             */
+class DateTimeMerger {
+public:
+	DateTimeMerger(DateTimeReader* const* streams, size_t k);
+
+	/* Writes up to \n merged values to \out and the index of the stream each came from to \streamIx (if not \nullptr). */
+	/* Returns less than \n only at the end of the merge.                                                               */
+	size_t next(DateTime* out, uint32_t* streamIx, size_t n);
+	bool   done() const   { return heads[tree[0]] == END; }
+
+private:
+	constexpr static uint64_t END = ~uint64_t(0); // larger than any \DateTime::rawKey(), marks exhausted streams
+
+	struct Cursor {
+		DateTimeReader* reader = nullptr;
+		const DateTime* pos    = nullptr;
+		const DateTime* end    = nullptr;
+	};
+
+	bool less(uint32_t a, uint32_t b) const   { return (heads[a] < heads[b]) | ((heads[a] == heads[b]) & (a < b)); }
+	void refill(uint32_t s);
+	void replay(uint32_t s);
+	uint64_t runLimit(uint32_t w) const;
+
+	size_t leaves = 1;             // number of streams rounded up to a power of 2; the padding streams are empty
+	std::vector<uint64_t> heads;   // key of the current head of each stream, \END if exhausted
+	std::vector<Cursor>   cursors;
+	std::vector<uint32_t> tree;    // \tree[p] is the loser of the match at inner node \p, \tree[0] the overall winner
+	uint32_t last = ~uint32_t(0);  // the previous winner
+};
+
+} /* end of namespace */
+
+#undef PROJECT_NAMESPACE
@@ -0,0 +1,93 @@
+#include "DateTimeRolling.h"
+#include "Version.h"
+
+#include <limits>
+
+using namespace PROJECT_NAMESPACE;
+
+using DO = DateTime::dayOffset_t;
+
+namespace {
+	constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+	inline DO floorMod7(DO o)   { return ((o % 7) + 7) % 7; } // 0 == Monday, since day offset 0 (0001-01-01) is a Monday
+} /* end of anonymous namespace */
+
+
+
+DateTimeRolling::DateTimeRolling(RollingWindow kind, unsigned int n) :
+	kind(kind),   n(n ? n : 1)
+{ }
+
+
+DO DateTimeRolling::windowStart(DO last) const {
+	switch(kind) {
+	case RollingWindow::TRAILING_DAYS:   return last - n + 1;
+	case RollingWindow::MONTH_TO_DATE:   return DateTime{ last }.monthFirst().dayOffset();
+	case RollingWindow::YEAR_TO_DATE:    return DateTime{ last }.yearFirst ().dayOffset();
+	case RollingWindow::BUSINESS_DAYS: {
+		const DO wd = floorMod7(last);
+		const DO e = last - (wd > 4 ? wd - 4 : 0), we = (wd > 4 ? 4 : wd); // the last business day, and its weekday
+		const DO k = (n - 1) / 5, r = (n - 1) % 5;                          // whole weeks and remaining business days to go back
+		return e - 7 * k - r - (r > we ? 2 : 0);
+	}
+	}
+	return last;
+}
+
+
+bool DateTimeRolling::push(const DateTime& D, double value) {
+	if(!D.hasDay())   return false;
+	const DO day = D.dayOffset();
+	if(!window.empty() && day < lastDay)   return false;
+	if(window.empty() || day != lastDay) { // the window only moves when the day changes
+		lastDay = day;
+		const DO start = windowStart(day);
+		while(!window.empty() && window.front().day < start) {
+			total -= window.front().value;
+			window.pop_front();
+		}
+		if(window.empty())   total = 0; // drops the rounding errors of the subtractions, e.g. at each new month for MONTH_TO_DATE
+		const uint64_t firstSeq = nextSeq - window.size();
+		while(!mins.empty() && mins.front().seq < firstSeq)   mins.pop_front();
+		while(!maxs.empty() && maxs.front().seq < firstSeq)   maxs.pop_front();
+	}
+
+	window.push_back(Value{ day, value });
+	total += value;
+	while(!mins.empty() && !(mins.back().value < value))   mins.pop_back();
+	while(!maxs.empty() && !(maxs.back().value > value))   maxs.pop_back();
+	mins.push_back(Entry{ nextSeq, value });
+	maxs.push_back(Entry{ nextSeq, value });
+	++nextSeq;
+	return true;
+}
+
+
+void DateTimeRolling::clear() {
+	lastDay = 0;
+	total = 0;
+	window.clear();
+	mins.clear();
+	maxs.clear();
+}
+
+
+double DateTimeRolling::mean() const   { return (window.empty() ? NaN : total / double(window.size())); }
+double DateTimeRolling::min () const   { return (mins.empty() ? NaN : mins.front().value); }
+double DateTimeRolling::max () const   { return (maxs.empty() ? NaN : maxs.front().value); }
+
+
+
+void PROJECT_NAMESPACE::rolling(const DateTime* D, const double* values, size_t n, RollingWindow kind, unsigned int windowLength,
+                                double* sums, double* means, double* mins, double* maxs, size_t* counts) {
+	DateTimeRolling R(kind, windowLength);
+	for(size_t i = 0;     i < n;     ++i) {
+		R.push(D[i], values[i]);
+		if(sums)     sums  [i] = R.sum();
+		if(means)    means [i] = R.mean();
+		if(mins)     mins  [i] = R.min();
+		if(maxs)     maxs  [i] = R.max();
+		if(counts)   counts[i] = R.count();
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "DateTime.h"
+#include "Version.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PROJECT_NAMESPACE {
+
+/* Rolling aggregates over calendar windows of a time series that arrives sorted by \DateTime (gaps and several values per day  */
+/* are fine). Windows are measured in whole days (time-of-day is ignored) and always end with the day of the latest value:       */
+/*  * TRAILING_DAYS   the last \n calendar days, i.e. day offsets \{(dayOffset() - n, dayOffset()]}                                */
+/*  * MONTH_TO_DATE   from \monthFirst() on                                                                                       */
+/*  * YEAR_TO_DATE    from \yearFirst() on                                                                                        */
+/*  * BUSINESS_DAYS   from the \n-th last business day (Monday...Friday, without holidays) on; values on weekends in between count */
+enum class RollingWindow : unsigned char { TRAILING_DAYS, MONTH_TO_DATE, YEAR_TO_DATE, BUSINESS_DAYS };
+
+/* Streaming operator: values leave the window in the order they arrived, so the sum is kept by adding and subtracting, and   */
+/* min/max by monotonic deques (each value is pushed and popped at most once). Every \push() costs amortised O(1).           */
+class DateTimeRolling {
+public:
+	DateTimeRolling(RollingWindow, unsigned int n = 1); // \n is only used by TRAILING_DAYS and BUSINESS_DAYS, and must be >= 1
+
+	/* Adds the next value and moves the window to end on its day. Returns \false (and ignores the value) if the date is n/a  */
+	/* or earlier than that of the previous value.                                                                            */
+	bool push(const DateTime&, double value);
+	void clear();
+
+	/* Aggregates over the current window; \mean(), \min() and \max() are NaN if it is empty */
+	size_t count() const   { return window.size(); }
+	double sum  () const   { return total; }
+	double mean () const;
+	double min  () const;
+	double max  () const;
+
+	/* first day offset that belongs to the window ending on day offset \last */
+	DateTime::dayOffset_t windowStart(DateTime::dayOffset_t last) const;
+
+private:
+	struct Value {
+		DateTime::dayOffset_t day;
+		double                value;
+	};
+	struct Entry {
+		uint64_t seq; // number of the value since construction, tells whether it is still in the window
+		double   value;
+	};
+	/* \std::deque allocates and frees a block every few hundred elements, but the windows here keep a steady size; so this is a */
+	/* vector that drops its popped front part whenever that makes up half of it (amortised O(1) as well)                     */
+	template<typename T>
+	struct Queue {
+		bool     empty() const   { return head == v.size(); }
+		size_t   size () const   { return v.size() - head; }
+		const T& front() const   { return v[head]; }
+		const T& back () const   { return v.back(); }
+		void push_back(const T& x)   { v.push_back(x); }
+		void pop_back ()             { v.pop_back(); }
+		void pop_front()             { if(++head >= 64 && 2 * head >= v.size())   { v.erase(v.begin(), v.begin() + head);     head = 0; } }
+		void clear    ()             { v.clear();     head = 0; }
+	private:
+		std::vector<T> v;
+		size_t head = 0;
+	};
+
+	RollingWindow kind;
+	unsigned int n;
+	DateTime::dayOffset_t lastDay = 0;
+	uint64_t nextSeq = 0;
+	double total = 0;
+	Queue<Value> window;     // oldest first
+	Queue<Entry> mins, maxs; // increasing resp. decreasing values; the fronts are the extremes
+};
+
+/* The whole series at once: entry \i of each output array (any of which may be \nullptr) describes the window ending with */
+/* value \i. n/a or out-of-order dates are skipped, and their outputs repeat the previous window.                           */
+void rolling(const DateTime*, const double* values, size_t n, RollingWindow, unsigned int windowLength,
+             double* sums, double* means, double* mins, double* maxs, size_t* counts = nullptr);
+
+} /* end of namespace */
+
+#undef PROJECT_NAMESPACE
@@ -0,0 +1,149 @@
+#include "DateTimeRollup.h"
+#include "Version.h"
+
+#include <algorithm>
+
+using namespace PROJECT_NAMESPACE;
+
+namespace {
+	constexpr uint64_t DAYBITS   = 0x00000000F8000000; // bit layout of \DateTime::rawKey(): year 36...63, month 32...35, day 27...31, time 0...26
+	constexpr uint64_t MONTHBITS = 0x0000000F00000000;
+
+	typedef DateTimeRollup::Aggregate Aggregate;
+
+	inline Aggregate single(double v)   { return Aggregate{ v, 1, v, v }; }
+
+	// applies a changed, inserted or erased value to \a; returns \false if \a must be recomputed because its old extremum is gone
+	bool change(Aggregate& a, double old, double value, bool inserted, bool erased) {
+		if(erased) {
+			--a.count;
+			a.sum -= old;
+			return old != a.min && old != a.max;
+		}
+		if(inserted)   { ++a.count;     a.sum += value; }
+		else             a.sum += value - old;
+		a.min = std::min(a.min, value);
+		a.max = std::max(a.max, value);
+		return inserted || !((old == a.min && value > old) || (old == a.max && value < old));
+	}
+
+	template<typename Node, typename F>
+	Aggregate sum(const std::map<uint64_t, Node>& nodes, uint64_t lo, uint64_t hi, F&& aggregate) { // nodes with keys in [lo, hi]
+		Aggregate a;
+		for(auto it = nodes.lower_bound(lo);     it != nodes.end() && it->first <= hi;     ++it)   a += aggregate(it->second);
+		return a;
+	}
+} /* end of anonymous namespace */
+
+
+
+Aggregate& DateTimeRollup::Aggregate::operator+=(const Aggregate& a) {
+	sum   += a.sum;
+	count += a.count;
+	min    = std::min(min, a.min);
+	max    = std::max(max, a.max);
+	return *this;
+}
+
+
+DateTime DateTimeRollup::monthKey(const DateTime& D)   { return DateTime::fromRawKey(D.monthFirst().rawKey() | DAYBITS); }
+DateTime DateTimeRollup::yearKey (const DateTime& D)   { return DateTime::fromRawKey(D.yearFirst ().rawKey() | MONTHBITS | DAYBITS); }
+
+
+Aggregate DateTimeRollup::days(const Month& M, unsigned int first, unsigned int last) {
+	Aggregate a;
+	for(unsigned int d = first;     d <= last;     ++d)
+		if(M.present >> d & 1)   a += single(M.value[d]);
+	return a;
+}
+
+
+
+bool DateTimeRollup::set(const DateTime& D, double value) {
+	if(!D.hasDay())   return false;
+	const uint64_t yk = yearKey(D).rawKey();
+	Month& M = months[monthKey(D).rawKey()];
+	const unsigned int d = D.day() - 1u;
+	const bool inserted = !(M.present >> d & 1);
+	const double old = (inserted ? value : M.value[d]);
+	M.value[d] = value;
+	M.present |= uint32_t(1) << d;
+	nDays += inserted;
+	// the month must be updated before its year, because the year's min/max are recomputed from its months
+	if(!change(M.total, old, value, inserted, false))   M.total = days(M, 0, 30);
+	Aggregate& Y = years[yk];
+	if(!change(Y, old, value, inserted, false))   Y = sum(months, D.yearFirst().rawKey(), yk, [](const Month& m) { return m.total; });
+	return true;
+}
+
+
+bool DateTimeRollup::erase(const DateTime& D) {
+	if(!D.hasDay())   return false;
+	const auto m = months.find(monthKey(D).rawKey());
+	const unsigned int d = D.day() - 1u;
+	if(m == months.end() || !(m->second.present >> d & 1))   return false;
+	Month& M = m->second;
+	const double old = M.value[d];
+	M.present &= ~(uint32_t(1) << d);
+	--nDays;
+	if(!M.present)   months.erase(m);
+	else if(!change(M.total, old, old, false, true))   M.total = days(M, 0, 30);
+	const uint64_t yk = yearKey(D).rawKey();
+	const auto y = years.find(yk);
+	if(y->second.count == 1)   years.erase(y);
+	else if(!change(y->second, old, old, false, true))   y->second = sum(months, D.yearFirst().rawKey(), yk, [](const Month& m) { return m.total; });
+	return true;
+}
+
+
+void DateTimeRollup::clear() {
+	months.clear();
+	years.clear();
+	nDays = 0;
+}
+
+
+
+Aggregate DateTimeRollup::day(const DateTime& D) const {
+	if(!D.hasDay())   return Aggregate{};
+	const auto m = months.find(monthKey(D).rawKey());
+	const unsigned int d = D.day() - 1u;
+	return (m != months.end() && m->second.present >> d & 1 ? single(m->second.value[d]) : Aggregate{});
+}
+
+Aggregate DateTimeRollup::month(const DateTime& D) const {
+	if(!D.hasMonth())   return Aggregate{};
+	const auto m = months.find(monthKey(D).rawKey());
+	return (m != months.end() ? m->second.total : Aggregate{});
+}
+
+Aggregate DateTimeRollup::year(const DateTime& D) const {
+	if(!D.hasYear())   return Aggregate{};
+	const auto y = years.find(yearKey(D).rawKey());
+	return (y != years.end() ? y->second : Aggregate{});
+}
+
+
+// Days at the edges, then months up to the year boundaries, then whole years. The nodes of each level between two keys are
+// contiguous in their map, so each step is one \lower_bound plus a short walk.
+Aggregate DateTimeRollup::range(const DateTime& from, const DateTime& to) const {
+	Aggregate a;
+	if(!from.hasDay() || !to.hasDay() || to.dayOffset() < from.dayOffset())   return a;
+	const auto total = [](const Month& m) { return m.total; };
+	const auto edge = [&](const DateTime& D, unsigned int first, unsigned int last) {
+		const auto m = months.find(monthKey(D).rawKey());
+		return (m != months.end() ? days(m->second, first, last) : Aggregate{});
+	};
+	DateTime first(from.year(), from.month(), from.day()), last(to.year(), to.month(), to.day()); // without time-of-day
+	if(first.monthFirst() == last.monthFirst())   return edge(first, first.day() - 1u, last.day() - 1u);
+
+	if(!first.isMonthFirst())   { a += edge(first, first.day() - 1u, 30);     first = DateTime{ first.monthLast().dayOffset() + 1 }; }
+	if(!last .isMonthLast ())   { a += edge(last, 0, last.day() - 1u);        last  = DateTime{ last.monthFirst().dayOffset() - 1 }; }
+	if(last < first)   return a; // two adjacent partial months
+	if(first.year() == last.year())   return a += sum(months, monthKey(first).rawKey(), monthKey(last).rawKey(), total);
+
+	if(first.month() != 1)    { a += sum(months, monthKey(first).rawKey(), yearKey(first).rawKey(), total);     first = DateTime{ first.yearLast().dayOffset() + 1 }; }
+	if(last.month()  != 12)   { a += sum(months, last.yearFirst().rawKey(), monthKey(last).rawKey(), total);    last  = DateTime{ last.yearFirst().dayOffset() - 1 }; }
+	if(!(last < first))   a += sum(years, yearKey(first).rawKey(), yearKey(last).rawKey(), [](const Aggregate& y) { return y; });
+	return a;
+}
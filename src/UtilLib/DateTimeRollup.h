@@ -0,0 +1,65 @@
+#pragma once
+
+#include "DateTime.h"
+#include "Version.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+
+namespace PROJECT_NAMESPACE {
+
+/* Daily values with cached aggregates per month and per year. Months and years are keyed by partial-resolution \DateTime\s:     */
+/* a month by \monthFirst() with n/a day, a year by \yearFirst() with n/a month (and thus n/a day). Since n/a sorts after all    */
+/* valid values, a month key comes right after the last day of its month and a year key right after its December.                */
+/* The day values of a month are stored in its node, so the days at the edges of a range need no lookups of their own.          */
+/*                                                                                                                                */
+/* Month and year aggregates are updated with each \set() or \erase(); min/max are recomputed from the next lower level only     */
+/* when the old value was the extremum. A range query combines whole years, whole months and single days at the edges, so it     */
+/* visits at most two month nodes for the edge days, 2 * 11 month nodes, and one node per whole year.                            */
+class DateTimeRollup {
+public:
+	struct Aggregate {
+		double   sum   = 0;
+		uint64_t count = 0;
+		double   min   =  std::numeric_limits<double>::infinity();
+		double   max   = -std::numeric_limits<double>::infinity();
+
+		double mean() const   { return count ? sum / double(count) : std::numeric_limits<double>::quiet_NaN(); }
+		Aggregate& operator+=(const Aggregate&);
+	};
+
+	/* Insert or replace the value of a day; time-of-day is ignored. Returns \false (and does nothing) if the day is n/a. */
+	bool set  (const DateTime&, double value);
+	bool erase(const DateTime&); // returns \false if there was no value for that day
+
+	/* Aggregates of the day, month or year that contain the argument; empty (\{count == 0}) if there's nothing or the units are n/a */
+	Aggregate day  (const DateTime&) const;
+	Aggregate month(const DateTime&) const;
+	Aggregate year (const DateTime&) const;
+	/* Aggregate of all days in [\from, \to]; time-of-day is ignored */
+	Aggregate range(const DateTime& from, const DateTime& to) const;
+
+	size_t size() const   { return nDays; } // number of days with a value
+	void   clear();
+
+	static DateTime monthKey(const DateTime&); // partial-resolution keys as described above
+	static DateTime yearKey (const DateTime&);
+
+private:
+	struct Month {
+		Aggregate total;
+		uint32_t  present = 0; // bit \{d - 1} is set if day \d has a value
+		double    value[31];
+	};
+	static Aggregate days(const Month&, unsigned int first, unsigned int last); // aggregate of days \first...\last (0-based)
+
+	std::map<uint64_t, Month>     months; // keyed by \DateTime::rawKey() of \monthKey()
+	std::map<uint64_t, Aggregate> years;  // keyed by \DateTime::rawKey() of \yearKey()
+	size_t nDays = 0;
+};
+
+} /* end of namespace */
+
+#undef PROJECT_NAMESPACE
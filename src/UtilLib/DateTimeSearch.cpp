@@ -0,0 +1,119 @@
+#include "DateTimeSearch.h"
+#include "Version.h"
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#	include <xmmintrin.h>
+#	define DATETIME_PREFETCH(p) _mm_prefetch(reinterpret_cast<const char*>(p), _MM_HINT_T0)
+#else
+#	define DATETIME_PREFETCH(p) __builtin_prefetch(p)
+#endif
+
+using namespace PROJECT_NAMESPACE;
+
+namespace {
+	constexpr uint64_t PADDING = ~uint64_t(0); // larger than any \DateTime::rawKey() because time-of-day never has all bits set
+	constexpr size_t   BATCH   = 16;           // probes walking down the tree together
+
+	inline unsigned int trailingOnes(uint64_t k) {
+#if defined(_MSC_VER)
+		unsigned long i;
+		_BitScanForward64(&i, ~k);
+		return i;
+#else
+		return __builtin_ctzll(~k);
+#endif
+	}
+
+	// after the descent \k encodes the path taken; the last left turn (the last 0 bit) marks the result node, 0 if there's none
+	inline size_t resultNode(size_t k)   { return k >> (trailingOnes(k) + 1); }
+
+	// fill \keys in Eytzinger order by an in-order traversal of the implicit tree
+	size_t fill(std::vector<uint64_t>& keys, std::vector<size_t>& ix, const DateTime* sorted, size_t n, size_t i, size_t k) {
+		if(k >= keys.size())   return i;
+		i = fill(keys, ix, sorted, n, i, 2 * k);
+		keys[k] = (i < n ? sorted[i].rawKey() : PADDING);
+		ix  [k] = (i < n ? i : n);
+		return fill(keys, ix, sorted, n, i + 1, 2 * k + 1);
+	}
+
+	int64_t distance(const DateTime& from, const DateTime& to, ToleranceUnit unit) {
+		const int64_t days = to.dayOffset() - from.dayOffset();
+		if(unit == ToleranceUnit::DAYS)   return days;
+		const int64_t t0 = (from.hasTime() ? from.time() : 0), t1 = (to.hasTime() ? to.time() : 0);
+		return days * 86400000 + (t1 - t0);
+	}
+} /* end of anonymous namespace */
+
+
+
+DateTimeIndex::DateTimeIndex(const DateTime* sorted, size_t n) : n(n) {
+	while((size_t(1) << depth) - 1 < n)   ++depth;
+	keys    .resize(size_t(1) << depth);
+	sortedIx.resize(size_t(1) << depth);
+	keys[0] = PADDING;     sortedIx[0] = n; // node 0 is the "not found" result of the descent
+	fill(keys, sortedIx, sorted, n, 0, 1);
+}
+
+
+template<bool upper>
+size_t DateTimeIndex::search(uint64_t x) const {
+	const uint64_t* b = keys.data();
+	size_t k = 1;
+	for(unsigned int i = 0;     i < depth;     ++i) {
+		DATETIME_PREFETCH(b + 16 * k); // the 16 nodes four levels further down are contiguous
+		k = 2 * k + (upper ? b[k] <= x : b[k] < x);
+	}
+	return sortedIx[resultNode(k)];
+}
+
+template<bool upper>
+void DateTimeIndex::search(const DateTime* probes, size_t nProbes, size_t* out) const {
+	const uint64_t* b = keys.data();
+	for(size_t p0 = 0;     p0 < nProbes;     p0 += BATCH) {
+		const size_t m = (nProbes - p0 < BATCH ? nProbes - p0 : BATCH);
+		uint64_t x[BATCH];
+		size_t   k[BATCH];
+		for(size_t j = 0;     j < m;     ++j)   { x[j] = probes[p0 + j].rawKey();     k[j] = 1; }
+		for(unsigned int i = 0;     i < depth;     ++i)
+			for(size_t j = 0;     j < m;     ++j) {
+				DATETIME_PREFETCH(b + 16 * k[j]);
+				k[j] = 2 * k[j] + (upper ? b[k[j]] <= x[j] : b[k[j]] < x[j]);
+			}
+		for(size_t j = 0;     j < m;     ++j)   out[p0 + j] = sortedIx[resultNode(k[j])];
+	}
+}
+
+
+size_t DateTimeIndex::lowerBound(const DateTime& D) const { return search<false>(D.rawKey()); }
+size_t DateTimeIndex::upperBound(const DateTime& D) const { return search<true >(D.rawKey()); }
+size_t DateTimeIndex::asOf      (const DateTime& D) const { const size_t i = search<true>(D.rawKey());     return (i ? i - 1 : NOINDEX); }
+
+void DateTimeIndex::lowerBound(const DateTime* probes, size_t nProbes, size_t* out) const { search<false>(probes, nProbes, out); }
+void DateTimeIndex::upperBound(const DateTime* probes, size_t nProbes, size_t* out) const { search<true >(probes, nProbes, out); }
+void DateTimeIndex::asOf(const DateTime* probes, size_t nProbes, size_t* out) const {
+	search<true>(probes, nProbes, out);
+	for(size_t i = 0;     i < nProbes;     ++i)   out[i] = (out[i] ? out[i] - 1 : NOINDEX);
+}
+
+
+
+void PROJECT_NAMESPACE::asOfJoin(const DateTime* events, size_t nEvents, const DateTime* quotes, size_t nQuotes, size_t* match) {
+	size_t q = 0; // number of quotes <= the current event
+	for(size_t i = 0;     i < nEvents;     ++i) {
+		const uint64_t e = events[i].rawKey();
+		while(q < nQuotes && quotes[q].rawKey() <= e)   ++q;
+		match[i] = (q ? q - 1 : NOINDEX);
+	}
+}
+
+
+void PROJECT_NAMESPACE::asOfJoin(const DateTime* events, size_t nEvents, const DateTime* quotes, size_t nQuotes, size_t* match,
+                                 int64_t tolerance, ToleranceUnit unit) {
+	asOfJoin(events, nEvents, quotes, nQuotes, match);
+	for(size_t i = 0;     i < nEvents;     ++i) {
+		const size_t q = match[i];
+		if(q != NOINDEX && (!events[i].hasDay() || !quotes[q].hasDay() || distance(quotes[q], events[i], unit) > tolerance))
+			match[i] = NOINDEX;
+	}
+}
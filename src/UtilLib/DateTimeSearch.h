@@ -0,0 +1,58 @@
+#pragma once
+
+#include "DateTime.h"
+#include "Version.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace PROJECT_NAMESPACE {
+
+/* Searching in sorted arrays of \DateTime. Everything works on \DateTime::rawKey(), i.e. on the ordering of \operator<. */
+
+constexpr size_t NOINDEX = ~size_t(0);
+
+/* Search index over a sorted \DateTime array in Eytzinger (breadth-first binary tree) layout. Each lookup takes the same number */
+/* of branch-free steps, and since the nodes of the next levels lie close together they can be prefetched.                       */
+/* The results are indices into the sorted array the index was built from.                                                        */
+class DateTimeIndex {
+public:
+	DateTimeIndex() = default;
+	DateTimeIndex(const DateTime* sorted, size_t n);
+
+	size_t size() const   { return n; }
+
+	size_t lowerBound(const DateTime&) const; // first element >= the argument, \size() if there is none
+	size_t upperBound(const DateTime&) const; // first element >  the argument, \size() if there is none
+	size_t asOf      (const DateTime&) const; // last element <= the argument, \NOINDEX if there is none
+
+	/* Batched versions: several probes walk down the tree in lockstep, so their memory accesses overlap */
+	void lowerBound(const DateTime* probes, size_t nProbes, size_t* out) const;
+	void upperBound(const DateTime* probes, size_t nProbes, size_t* out) const;
+	void asOf      (const DateTime* probes, size_t nProbes, size_t* out) const;
+
+private:
+	template<bool upper> size_t search(uint64_t) const;
+	template<bool upper> void   search(const DateTime*, size_t, size_t*) const;
+
+	size_t n = 0;
+	unsigned int depth = 0;        // number of tree levels
+	std::vector<uint64_t> keys;    // 1-based Eytzinger order, padded to a complete tree with keys that are larger than any \DateTime
+	std::vector<size_t>   sortedIx; // position of each node in the sorted input (\n for padding)
+};
+
+
+/* As-of join of two sorted arrays: \match[i] is the index of the last element of \quotes that is <= \events[i], or \NOINDEX. */
+/* The join merges both arrays in one pass, so it costs O(\nEvents + \nQuotes).                                                 */
+void asOfJoin(const DateTime* events, size_t nEvents, const DateTime* quotes, size_t nQuotes, size_t* match);
+
+/* As above, but matches that lie more than \tolerance before the event are dropped (-> \NOINDEX).                               */
+/* DAYS compares calendar days and ignores time-of-day; MILLISECONDS compares full date-times (n/a time-of-day counts as 00:00). */
+/* Events or quotes with n/a day never match.                                                                                    */
+enum class ToleranceUnit : unsigned char { DAYS, MILLISECONDS };
+void asOfJoin(const DateTime* events, size_t nEvents, const DateTime* quotes, size_t nQuotes, size_t* match,
+              int64_t tolerance, ToleranceUnit);
+
+} /* end of namespace */
+
+#undef PROJECT_NAMESPACE
@@ -0,0 +1,234 @@
+#include "DateTime_arrow.h"
+#include "DateTimeArray.h"
+#include "Version.h"
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace PROJECT_NAMESPACE;
+
+using DO = DateTime::dayOffset_t;
+
+namespace {
+	constexpr int64_t msPerDay = 86400000;
+	constexpr DO epochOffset = DateTime::dayOffset(1970, 1, 1); // 1970-01-01 counted from 0001-01-01
+	constexpr size_t CHUNK = 256; // the export kernels get the day offsets from \dayOffsets() for this many values at a time;
+	                              // a multiple of 8, so each chunk fills whole bytes of the validity bitmap
+
+	// the tests on day offsets compare 32 bit halves, since SSE2 has no 64 bit comparisons
+	inline bool valid(DO o) {
+		return (uint32_t(uint64_t(o) >> 32) != uint32_t(uint64_t(DateTime::NODAYOFFSET) >> 32)) | (uint32_t(o) != uint32_t(DateTime::NODAYOFFSET));
+	}
+
+	constexpr unsigned char popcount8[256] = { // number of set bits of each byte value
+#define B2(n) n, n + 1, n + 1, n + 2
+#define B4(n) B2(n), B2(n + 1), B2(n + 1), B2(n + 2)
+#define B6(n) B4(n), B4(n + 1), B4(n + 1), B4(n + 2)
+		B6(0), B6(1), B6(1), B6(2)
+#undef B6
+#undef B4
+#undef B2
+	};
+
+	inline int64_t floorDiv(int64_t a, int64_t b)   { return a / b - (a % b < 0); }
+
+	template<typename F>
+	int64_t fillValidity(const DO* offs, size_t n, uint8_t* validity, F&& isValid) {
+		int64_t nValid = 0;
+		size_t i = 0;
+		for(;     i + 8 <= n;     i += 8) { // whole bytes; the fixed trip count lets the compiler unroll the inner loop
+			unsigned int bits = 0;
+			for(unsigned int j = 0;     j < 8;     ++j)   bits |= unsigned(isValid(offs[i + j])) << j;
+			validity[i >> 3] = uint8_t(bits);
+			nValid += popcount8[bits];
+		}
+		if(i < n) {
+			unsigned int bits = 0;
+			for(unsigned int j = 0;     i + j < n;     ++j)   bits |= unsigned(isValid(offs[i + j])) << j;
+			validity[i >> 3] = uint8_t(bits);
+			nValid += popcount8[bits];
+		}
+		return int64_t(n) - nValid;
+	}
+
+	/* Runs \dayOffsets() chunk by chunk; \value(offset, \DateTime) gives the Arrow value of valid slots, the others get 0 */
+	template<typename T, typename V, typename F>
+	int64_t toArrow(const DateTime* in, size_t n, T* out, uint8_t* validity, V&& value, F&& isValid) {
+		DO offs[CHUNK];
+		int64_t nullCount = 0;
+		for(size_t i0 = 0;     i0 < n;     i0 += CHUNK) {
+			const size_t m = (n - i0 < CHUNK ? n - i0 : CHUNK);
+			dayOffsets(in + i0, m, offs);
+			for(size_t i = 0;     i < m;     ++i)   out[i0 + i] = value(offs[i], in[i0 + i]) & (T(0) - T(isValid(offs[i]))); // no select, see above
+			nullCount += fillValidity(offs, m, validity + (i0 >> 3), isValid);
+		}
+		return nullCount;
+	}
+
+	inline bool isSet(const uint8_t* validity, int64_t i)   { return !validity || (validity[i >> 3] >> (i & 7)) & 1; }
+
+	const char* formatString(ArrowDateFormat F) {
+		switch(F) {
+		case ArrowDateFormat::DATE32:         return "tdD";
+		case ArrowDateFormat::DATE64:         return "tdm";
+		case ArrowDateFormat::TIMESTAMP_MS:   return "tsm:";
+		}
+		return "";
+	}
+
+	/* producer side: the schema has no allocations, the array owns its buffers through \ArrayData */
+	void releaseSchema(ArrowSchema* S)   { S->release = nullptr; }
+
+	void initSchema(ArrowSchema* S, ArrowDateFormat F) {
+		S->format = formatString(F);
+		S->name = "";
+		S->metadata = nullptr;
+		S->flags = ARROW_FLAG_NULLABLE;
+		S->n_children = 0;
+		S->children = nullptr;
+		S->dictionary = nullptr;
+		S->release = releaseSchema;
+		S->private_data = nullptr;
+	}
+
+	struct ArrayData {
+		std::vector<uint8_t> validity;
+		std::vector<int32_t> days; // the value buffer is typed, so it is aligned for its element type; only one of them is used
+		std::vector<int64_t> ms;
+		const void* buffers[2];
+	};
+
+	void releaseArray(ArrowArray* A) {
+		delete static_cast<ArrayData*>(A->private_data);
+		A->release = nullptr;
+	}
+
+	void releaseView(ArrowArray* A) {
+		delete[] A->buffers;
+		A->release = nullptr;
+	}
+
+	void initArray(ArrowArray* A, size_t n, int64_t nullCount, const void** buffers, void (*release)(ArrowArray*), void* privateData) {
+		A->length = int64_t(n);
+		A->null_count = nullCount;
+		A->offset = 0;
+		A->n_buffers = 2;
+		A->n_children = 0;
+		A->buffers = buffers;
+		A->children = nullptr;
+		A->dictionary = nullptr;
+		A->release = release;
+		A->private_data = privateData;
+	}
+} /* end of anonymous namespace */
+
+
+
+int64_t PROJECT_NAMESPACE::toArrowDate32(const DateTime* in, size_t n, int32_t* days, uint8_t* validity) {
+	constexpr int64_t lo = std::numeric_limits<int32_t>::min() + epochOffset; // the day numbers that fit are \lo + [0, 2^32)
+	return toArrow(in, n, days, validity, [](DO o, const DateTime&) { return int32_t(o - epochOffset); },
+	                                      [](DO o) { return uint32_t((uint64_t(o) - uint64_t(lo)) >> 32) == 0; }); // \NODAYOFFSET doesn't fit
+}
+
+int64_t PROJECT_NAMESPACE::toArrowDate64(const DateTime* in, size_t n, int64_t* ms, uint8_t* validity) {
+	return toArrow(in, n, ms, validity, [](DO o, const DateTime&) { return (o - epochOffset) * msPerDay; }, valid);
+}
+
+int64_t PROJECT_NAMESPACE::toArrowTimestampMs(const DateTime* in, size_t n, int64_t* ms, uint8_t* validity) {
+	return toArrow(in, n, ms, validity, [](DO o, const DateTime& D) {
+		const uint32_t t = uint32_t(D.rawKey()) & 0x07FFFFFF; // stored as milliseconds + 1, 0 for n/a
+		return (o - epochOffset) * msPerDay + (t - (t != 0));
+	}, valid);
+}
+
+
+
+// The day offsets of a chunk are collected first (n/a for null slots) and then converted by \fromDayOffsets()
+void PROJECT_NAMESPACE::fromArrowDate32(const int32_t* days, const uint8_t* validity, int64_t offset, size_t n, DateTime* out) {
+	DO offs[CHUNK];
+	for(size_t i0 = 0;     i0 < n;     i0 += CHUNK) {
+		const size_t m = (n - i0 < CHUNK ? n - i0 : CHUNK);
+		for(size_t i = 0;     i < m;     ++i) {
+			const DO mask = -DO(isSet(validity, offset + i0 + i));
+			offs[i] = ((epochOffset + days[offset + i0 + i]) & mask) | (DateTime::NODAYOFFSET & ~mask);
+		}
+		fromDayOffsets(offs, m, out + i0);
+	}
+}
+
+void PROJECT_NAMESPACE::fromArrowDate64(const int64_t* ms, const uint8_t* validity, int64_t offset, size_t n, DateTime* out) {
+	DO offs[CHUNK];
+	for(size_t i0 = 0;     i0 < n;     i0 += CHUNK) {
+		const size_t m = (n - i0 < CHUNK ? n - i0 : CHUNK);
+		for(size_t i = 0;     i < m;     ++i) {
+			const DO mask = -DO(isSet(validity, offset + i0 + i));
+			offs[i] = ((epochOffset + floorDiv(ms[offset + i0 + i], msPerDay)) & mask) | (DateTime::NODAYOFFSET & ~mask);
+		}
+		fromDayOffsets(offs, m, out + i0);
+	}
+}
+
+void PROJECT_NAMESPACE::fromArrowTimestampMs(const int64_t* ms, const uint8_t* validity, int64_t offset, size_t n, DateTime* out) {
+	DO offs[CHUNK];
+	uint32_t times[CHUNK]; // time-of-day as stored in the \DateTime word: milliseconds + 1, 0 for null slots
+	for(size_t i0 = 0;     i0 < n;     i0 += CHUNK) {
+		const size_t m = (n - i0 < CHUNK ? n - i0 : CHUNK);
+		for(size_t i = 0;     i < m;     ++i) {
+			const int64_t t = ms[offset + i0 + i], day = floorDiv(t, msPerDay);
+			const DO mask = -DO(isSet(validity, offset + i0 + i));
+			offs[i]  = ((epochOffset + day) & mask) | (DateTime::NODAYOFFSET & ~mask);
+			times[i] = uint32_t(t - day * msPerDay + 1) & uint32_t(mask);
+		}
+		fromDayOffsets(offs, m, out + i0);
+		for(size_t i = 0;     i < m;     ++i) {
+			uint64_t w = out[i0 + i].rawKey() | times[i];
+			std::memcpy(static_cast<void*>(out + i0 + i), &w, sizeof w);
+		}
+	}
+}
+
+
+
+void PROJECT_NAMESPACE::exportArrow(const DateTime* in, size_t n, ArrowDateFormat F, ArrowArray* A, ArrowSchema* S) {
+	ArrayData* data = new ArrayData;
+	data->validity.resize((n + 7) / 8);
+	if(F == ArrowDateFormat::DATE32)   data->days.resize(n);
+	else                               data->ms.resize(n);
+	int64_t nullCount = 0;
+	switch(F) {
+	case ArrowDateFormat::DATE32:         nullCount = toArrowDate32     (in, n, data->days.data(), data->validity.data());     break;
+	case ArrowDateFormat::DATE64:         nullCount = toArrowDate64     (in, n, data->ms.data(),   data->validity.data());     break;
+	case ArrowDateFormat::TIMESTAMP_MS:   nullCount = toArrowTimestampMs(in, n, data->ms.data(),   data->validity.data());     break;
+	}
+	data->buffers[0] = (nullCount ? data->validity.data() : nullptr); // Arrow allows omitting the bitmap if there are no nulls
+	data->buffers[1] = (F == ArrowDateFormat::DATE32 ? static_cast<const void*>(data->days.data()) : data->ms.data());
+	initArray(A, n, nullCount, data->buffers, releaseArray, data);
+	initSchema(S, F);
+}
+
+
+void PROJECT_NAMESPACE::exportArrowView(const void* values, const uint8_t* validity, size_t n, int64_t nullCount, ArrowDateFormat F,
+                                        ArrowArray* A, ArrowSchema* S) {
+	const void** buffers = new const void*[2]{ (nullCount ? validity : nullptr), values };
+	initArray(A, n, nullCount, buffers, releaseView, nullptr);
+	initSchema(S, F);
+}
+
+
+bool PROJECT_NAMESPACE::importArrow(const ArrowArray* A, const ArrowSchema* S, DateTime* out) {
+	const char* f = S->format;
+	if(!f || A->n_buffers != 2 || !A->buffers || A->length < 0 || A->offset < 0)   return false;
+	if(A->length && !A->buffers[1])   return false;
+	const uint8_t* validity = static_cast<const uint8_t*>(A->buffers[0]); // may be \nullptr if there are no nulls
+	if(!validity && A->null_count > 0)   return false;
+	const size_t n = size_t(A->length);
+	if(!std::strcmp(f, "tdD"))
+		fromArrowDate32(static_cast<const int32_t*>(A->buffers[1]), validity, A->offset, n, out);
+	else if(!std::strcmp(f, "tdm"))
+		fromArrowDate64(static_cast<const int64_t*>(A->buffers[1]), validity, A->offset, n, out);
+	else if(!std::strcmp(f, "tsm:") || !std::strcmp(f, "tsm:UTC"))
+		fromArrowTimestampMs(static_cast<const int64_t*>(A->buffers[1]), validity, A->offset, n, out);
+	else return false;
+	return true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "DateTime.h"
+#include "Version.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/* Exchange of \DateTime columns with Apache Arrow through the Arrow C Data Interface, which is an ABI and needs no Arrow library. */
+/* Supported Arrow types are date32 (days since 1970-01-01), date64 and timestamp[ms] (milliseconds since 1970-01-01 00:00).      */
+/* Dates with n/a day are null in Arrow; Arrow values outside the range of \DateTime become n/a dates.                             */
+
+/* The struct definitions below are copied verbatim from the Arrow C Data Interface specification (arrow/c/abi.h) */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+	// Array type description
+	const char* format;
+	const char* name;
+	const char* metadata;
+	int64_t flags;
+	int64_t n_children;
+	struct ArrowSchema** children;
+	struct ArrowSchema* dictionary;
+
+	// Release callback
+	void (*release)(struct ArrowSchema*);
+	// Opaque producer-specific data
+	void* private_data;
+};
+
+struct ArrowArray {
+	// Array data description
+	int64_t length;
+	int64_t null_count;
+	int64_t offset;
+	int64_t n_buffers;
+	int64_t n_children;
+	const void** buffers;
+	struct ArrowArray** children;
+	struct ArrowArray* dictionary;
+
+	// Release callback
+	void (*release)(struct ArrowArray*);
+	// Opaque producer-specific data
+	void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+
+namespace PROJECT_NAMESPACE {
+
+enum class ArrowDateFormat : unsigned char { DATE32, DATE64, TIMESTAMP_MS };
+
+/* Conversion kernels between \DateTime arrays and Arrow value buffers. They are branch-free; all of them except \fromArrowDate64 */
+/* and \fromArrowTimestampMs vectorise with plain SSE2. Those two need a 64 bit division per value to split milliseconds into     */
+/* days, but then convert the days with the same vectorised kernel (\fromDayOffsets()).                                            */
+/* Validity bitmaps follow Arrow (bit \i of byte \{i / 8}, 1 == valid) and need \{(n + 7) / 8} bytes. The functions return the     */
+/* null count; null slots get the value 0. DATE32 also treats dates whose day number doesn't fit into 32 bits as null.             */
+int64_t toArrowDate32     (const DateTime*, size_t n, int32_t* days, uint8_t* validity);
+int64_t toArrowDate64     (const DateTime*, size_t n, int64_t* ms,   uint8_t* validity); // time-of-day is dropped
+int64_t toArrowTimestampMs(const DateTime*, size_t n, int64_t* ms,   uint8_t* validity); // n/a time-of-day counts as 00:00
+
+/* \validity may be \nullptr if all values are valid; \offset is the Arrow slot offset (counted in values, also for the bitmap) */
+void fromArrowDate32     (const int32_t* days, const uint8_t* validity, int64_t offset, size_t n, DateTime*);
+void fromArrowDate64     (const int64_t* ms,   const uint8_t* validity, int64_t offset, size_t n, DateTime*); // time-of-day unset
+void fromArrowTimestampMs(const int64_t* ms,   const uint8_t* validity, int64_t offset, size_t n, DateTime*);
+
+/* Export as a new Arrow array; \array owns the converted buffers and frees them in its \release callback */
+void exportArrow(const DateTime*, size_t n, ArrowDateFormat, ArrowArray* array, ArrowSchema* schema);
+
+/* Zero-copy export of a column that is already held in Arrow layout (e.g. as filled in by \toArrowDate32). Nothing is copied:   */
+/* the caller must keep \values and \validity alive until the consumer has called \array->release.                               */
+void exportArrowView(const void* values, const uint8_t* validity, size_t n, int64_t nullCount, ArrowDateFormat,
+                     ArrowArray* array, ArrowSchema* schema);
+
+/* Import into \out, which must have room for \array->length values. Returns \false (leaving \out untouched) if \schema is not  */
+/* date32, date64 or timestamp[ms] without a time zone or with time zone UTC, or if \array is malformed (not two buffers, no    */
+/* value buffer, or nulls without a validity bitmap). \array is not released.                                                   */
+bool importArrow(const ArrowArray* array, const ArrowSchema* schema, DateTime* out);
+
+} /* end of namespace */
+
+#undef PROJECT_NAMESPACE
@@ -1,34 +1,122 @@
 #include "DateTime_boost.h"
+#include "DateTimeArray.h"
 #include "Version.h"
 
+#include <algorithm>
+
 using namespace PROJECT_NAMESPACE;
 using namespace boost::gregorian;
 
+using DO = DateTime::dayOffset_t;
 
-date PROJECT_NAMESPACE::toBoostDate(const DateTime& D) {
-	if(!D.isValid())   return date(special_values::not_a_date_time);
-	// Todo!! Ranges!
-	return date(D.year(), D.month(), D.day());
-}
+namespace {
+	typedef date::date_int_type dayNumber_t;
+
+	constexpr DO julianOffset = 1721426; // boost's day number of 0001-01-01, i.e. of \DateTime::dayOffset() 0
+	constexpr DO boostMin = DateTime::dayOffset(1400, 1, 1), boostMax = DateTime::dayOffset(9999, 12, 31);
+	const dayNumber_t NADT = date(not_a_date_time).day_number();
+	const dayNumber_t OUTOFRANGE = 1; // no boost date has this day number; makes out-of-range dates unequal to everything
+	constexpr size_t  CHUNK = 256;    // the array functions get the day offsets for this many values at a time
+
+	// The helpers below compare and select with 32 bit masks only, so that the array loops vectorise with plain SSE2 (which has no
+	// 64 bit comparisons). An offset is in range iff its distance from \boostMin, taken as unsigned, is at most \boostMax - \boostMin;
+	// \NODAYOFFSET (n/a dates) is out of range too.
+	inline dayNumber_t inRangeMask(DO o) {
+		const uint64_t u = uint64_t(o) - uint64_t(boostMin);
+		return dayNumber_t(0) - (dayNumber_t(uint32_t(u >> 32) == 0) & dayNumber_t(uint32_t(u) <= uint32_t(boostMax - boostMin)));
+	}
+	inline dayNumber_t naMask(DO o) { // \NODAYOFFSET, compared in halves for the same reason
+		return dayNumber_t(0) - (dayNumber_t(uint32_t(uint64_t(o) >> 32) == uint32_t(uint64_t(DateTime::NODAYOFFSET) >> 32)) &
+		                         dayNumber_t(uint32_t(o) == uint32_t(DateTime::NODAYOFFSET)));
+	}
+	inline dayNumber_t dayNumber(DO o) {
+		const dayNumber_t mask = inRangeMask(o);
+		return (dayNumber_t(o + julianOffset) & mask) | (NADT & ~mask);
+	}
+	inline dayNumber_t dayNumber(const DateTime& D)   { return dayNumber(D.dayOffset()); }
+
+	// what \operator== and \equalBoostDates() compare with \date::day_number()
+	inline dayNumber_t equalityKey(DO o) {
+		const dayNumber_t mask = inRangeMask(o), na = naMask(o);
+		return (dayNumber_t(o + julianOffset) & mask) | (NADT & na) | (OUTOFRANGE & ~(mask | na));
+	}
+
+	inline DateTime fromDayNumber(dayNumber_t n) { // the special values lie outside the range
+		return (n >= boostMin + julianOffset && n <= boostMax + julianOffset ? DateTime{ DO(n) - julianOffset } : DateTime{});
+	}
+} /* end of anonymous namespace */
+
+
+
+date PROJECT_NAMESPACE::toBoostDate(const DateTime& D)
+	{ return date(dayNumber(D)); }
 
 
 DateTime& PROJECT_NAMESPACE::setToBoostDate(DateTime& DT, const date& BD) {
-	DT.set(BD.year(), static_cast<DateTime::month_t>(BD.month()), static_cast<DateTime::day_t>(BD.day()));
+	const DateTime D = fromDayNumber(BD.day_number());
+	DT.set(D.year(), D.month(), D.day());
 	return DT;
 }
 
 
 DateTime PROJECT_NAMESPACE::fromBoostDate(const date& BD)
-	{ return DateTime{ BD.year(), static_cast<DateTime::month_t>(BD.month()), static_cast<DateTime::day_t>(BD.day()) }; }
+	{ return fromDayNumber(BD.day_number()); }
+
+
+void PROJECT_NAMESPACE::toBoostDates(const DateTime* in, size_t n, date* out) {
+	DO offs[CHUNK];
+	for(size_t i0 = 0;     i0 < n;     i0 += CHUNK) {
+		const size_t m = std::min(CHUNK, n - i0);
+		dayOffsets(in + i0, m, offs);
+		for(size_t i = 0;     i < m;     ++i)   out[i0 + i] = date(dayNumber(offs[i]));
+	}
+}
+
+
+void PROJECT_NAMESPACE::fromBoostDates(const date* in, size_t n, DateTime* out) {
+	DO offs[CHUNK];
+	for(size_t i0 = 0;     i0 < n;     i0 += CHUNK) {
+		const size_t m = std::min(CHUNK, n - i0);
+		for(size_t i = 0;     i < m;     ++i) {
+			const dayNumber_t k = in[i0 + i].day_number();
+			const uint64_t mask = uint64_t(0) - ((k >= boostMin + julianOffset) & (k <= boostMax + julianOffset)); // as above, no selects
+			offs[i] = DO(((uint64_t(k) - julianOffset) & mask) | (uint64_t(DateTime::NODAYOFFSET) & ~mask));
+		}
+		fromDayOffsets(offs, m, out + i0);
+	}
+}
+
+
+// each chunk is compared without early exit, so the loop vectorises; only a chunk with a mismatch is searched for it
+bool PROJECT_NAMESPACE::equalBoostDates(const DateTime* D, const date* B, size_t n, size_t* firstMismatch) {
+	DO offs[CHUNK];
+	dayNumber_t keys[CHUNK];
+	for(size_t i0 = 0;     i0 < n;     i0 += CHUNK) {
+		const size_t m = std::min(CHUNK, n - i0);
+		dayOffsets(D + i0, m, offs);
+		unsigned int differ = 0; // not \bool, which compilers don't vectorise as a reduction
+		for(size_t i = 0;     i < m;     ++i) {
+			keys[i] = equalityKey(offs[i]);
+			differ |= unsigned(keys[i] != B[i0 + i].day_number());
+		}
+		if(!differ)   continue;
+		size_t i = 0;
+		while(keys[i] == B[i0 + i].day_number())   ++i;
+		if(firstMismatch)   *firstMismatch = i0 + i;
+		return false;
+	}
+	if(firstMismatch)   *firstMismatch = n;
+	return true;
+}
 
 
 bool operator==(const DateTime& DT, const date& BD)
-	{ return DT.year() == BD.year() && DT.month() == BD.month() && DT.day() == BD.day(); }
+	{ return equalityKey(DT.dayOffset()) == BD.day_number(); }
 bool operator==(const date& BD, const DateTime& DT)
-	{ return DT.year() == BD.year() && DT.month() == BD.month() && DT.day() == BD.day(); }
+	{ return equalityKey(DT.dayOffset()) == BD.day_number(); }
 
 
 bool operator!=(const DateTime& DT, const date& BD)
-	{ return DT.year() != BD.year() || DT.month() != BD.month() || DT.day() != BD.day(); }
+	{ return equalityKey(DT.dayOffset()) != BD.day_number(); }
 bool operator!=(const date& BD, const DateTime& DT)
-	{ return DT.year() != BD.year() || DT.month() != BD.month() || DT.day() != BD.day(); }
+	{ return equalityKey(DT.dayOffset()) != BD.day_number(); }
@@ -4,19 +4,33 @@
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include "Version.h"
 
+#include <cstddef>
 
 namespace PROJECT_NAMESPACE {
 
+/* Conversions go through boost's internal day number (a Julian day number, cf. \date::day_number()) and \DateTime::dayOffset(), */
+/* so they skip boost's per-field validation and never throw. n/a dates and dates outside boost's range 1400-01-01...9999-12-31 */
+/* become \not_a_date_time; the boost special values (\not_a_date_time, +/-infinity) become n/a dates. Time-of-day is dropped.  */
 boost::gregorian::date toBoostDate(const DateTime&);
 
-DateTime& setToBoostDate(DateTime&, const boost::gregorian::date&);
+DateTime& setToBoostDate(DateTime&, const boost::gregorian::date&); // leaves time-of-day unchanged
 
 DateTime fromBoostDate(const boost::gregorian::date&);
 
+/* The same for whole arrays */
+void toBoostDates  (const DateTime*, size_t n, boost::gregorian::date*);
+void fromBoostDates(const boost::gregorian::date*, size_t n, DateTime*);
+
+/* Batch version of the \operator== below. If \firstMismatch isn't \nullptr it receives the index of the first pair that differs */
+/* (\n if all are equal).                                                                                                      */
+bool equalBoostDates(const DateTime*, const boost::gregorian::date*, size_t n, size_t* firstMismatch = nullptr);
+
 
 } /* end of namespace */
 
 
+/* Compare day numbers, so they never throw: n/a dates equal \not_a_date_time, valid dates outside boost's range equal nothing. */
+/* Time-of-day is ignored.                                                                                                     */
 bool operator==(const PROJECT_NAMESPACE::DateTime&, const boost::gregorian::date&);
 bool operator==(const boost::gregorian::date&, const PROJECT_NAMESPACE::DateTime&);
 